@@ -0,0 +1,68 @@
+// The library API with no terminal in the loop: search, borrow, reserve and
+// return on a synthetic catalogue, single-threaded, as the console and the
+// server call them.
+#include "LibrarySystem.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static void writeTextData(const std::string& dir, size_t books, size_t members) {
+    std::ofstream b(dir + "/books.txt");
+    for (size_t i = 1; i <= books; i++)
+        b << i << "|Synthetic Title " << i << "|Author " << (i % 2000) << "|Fiction|0|0||\n";
+    std::ofstream u(dir + "/users.txt");
+    u << "Librarian|admin|Admin|admin@library.com\n";
+    for (size_t i = 1; i <= members; i++) u << "Member|" << i << "|Member " << i << "|m" << i << "@mail.com|\n";
+}
+
+template <class F>
+static void report(const char* name, size_t calls, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%-10s %10zu calls %10.0f /s %8.2f us/call\n", name, calls, calls / s, s * 1e6 / calls);
+}
+
+int main(int argc, char** argv) {
+    size_t books = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t calls = argc > 2 ? std::stoul(argv[2]) : 20000;
+    size_t members = 10000;
+    std::string dir = "/tmp/library_bench_api";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    writeTextData(dir, books, members);
+
+    auto app = std::make_unique<LibrarySystem>(DataFormat::Text, dir, 1);
+    app->search("synthetic", 0, 1); // build the search index outside the timings
+
+    std::vector<std::string> bookIds, memberIds, other;
+    for (size_t i = 0; i < calls; i++) {
+        bookIds.push_back(std::to_string(i % books + 1));
+        memberIds.push_back(std::to_string(i % members + 1));
+        other.push_back(std::to_string((i + 1) % members + 1));
+    }
+
+    printf("books: %zu\n", books);
+    size_t hits = 0;
+    report("search", calls / 10, [&]() {
+        for (size_t i = 0; i < calls / 10; i++) hits += app->search("author " + std::to_string(i % 2000), 0, 20).size();
+    });
+    report("borrow", calls, [&]() {
+        for (size_t i = 0; i < calls; i++) app->borrow(memberIds[i], bookIds[i]);
+    });
+    report("reserve", calls, [&]() {
+        for (size_t i = 0; i < calls; i++) app->reserve(other[i], bookIds[i]);
+    });
+    double fines = 0;
+    report("return", calls, [&]() {
+        for (size_t i = 0; i < calls; i++) fines += app->returnBook(memberIds[i], bookIds[i]).fine.amount;
+    });
+    printf("(%zu search hits, RM%.2f fines)\n", hits, fines);
+
+    app.reset();
+    std::system(("rm -rf " + dir).c_str());
+    return 0;
+}
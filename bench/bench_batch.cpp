@@ -0,0 +1,79 @@
+// Bulk circulation: one call per item vs applyBatch() on a synthetic
+// catalogue. Borrows and returns compare against the session API
+// (borrow/returnBook); adds compare one-item batches against one batch,
+// with the search index built so both pay for keeping it current.
+#include "LibrarySystem.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static void writeTextData(const std::string& dir, size_t books, size_t members) {
+    std::ofstream b(dir + "/books.txt");
+    for (size_t i = 1; i <= books; i++)
+        b << i << "|Synthetic Title " << i << "|Author " << (i % 2000) << "|Fiction|0|0||\n";
+    std::ofstream u(dir + "/users.txt");
+    u << "Librarian|admin|Admin|admin@library.com\n";
+    for (size_t i = 1; i <= members; i++) u << "Member|" << i << "|Member " << i << "|m" << i << "@mail.com|\n";
+}
+
+template <class F>
+static double itemsPerSec(size_t items, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    return items / std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void row(const char* name, double single, double batch) {
+    printf("%-8s %14.0f %14.0f %8.1fx\n", name, single, batch, batch / single);
+}
+
+int main(int argc, char** argv) {
+    size_t books = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t items = argc > 2 ? std::stoul(argv[2]) : 20000;
+    size_t members = 10000;
+    std::string dir = "/tmp/library_bench_batch";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    writeTextData(dir, books, members);
+
+    auto app = std::make_unique<LibrarySystem>(DataFormat::Text, dir, 1);
+    app->search("synthetic", 0, 1); // build the search index
+
+    std::vector<BatchOp> borrows, returns, adds;
+    for (size_t i = 0; i < items; i++) {
+        std::string member = std::to_string(i % members + 1);
+        borrows.push_back(BatchOp{BatchOpKind::Borrow, std::to_string(i + 1), member, "", "", ""});
+        returns.push_back(BatchOp{BatchOpKind::Return, std::to_string(i + 1), member, "", "", ""});
+        adds.push_back(BatchOp{BatchOpKind::AddBook, "", "", "Imported Title " + std::to_string(i),
+                               "Imported Author " + std::to_string(i % 500), "Import"});
+    }
+
+    printf("books: %zu  items: %zu\n", books, items);
+    printf("%-8s %14s %14s %9s\n", "op", "single/s", "batch/s", "speedup");
+
+    double single = itemsPerSec(items, [&]() {
+        for (const BatchOp& op : borrows) app->borrow(op.memberId, op.bookId);
+    });
+    double singleReturn = itemsPerSec(items, [&]() {
+        for (const BatchOp& op : returns) app->returnBook(op.memberId, op.bookId);
+    });
+    double batch = itemsPerSec(items, [&]() { app->applyBatch(borrows); });
+    double batchReturn = itemsPerSec(items, [&]() { app->applyBatch(returns); });
+    row("borrow", single, batch);
+    row("return", singleReturn, batchReturn);
+
+    // One-item batches also fsync each time; a sample keeps this short
+    size_t sample = std::min<size_t>(items, 500);
+    double singleAdd = itemsPerSec(sample, [&]() {
+        for (size_t i = 0; i < sample; i++) app->applyBatch(std::vector<BatchOp>(1, adds[i]));
+    });
+    double batchAdd = itemsPerSec(items, [&]() { app->applyBatch(adds); });
+    row("add", singleAdd, batchAdd);
+
+    app.reset();
+    std::system(("rm -rf " + dir).c_str());
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Genre browsing: "available books in genre X" and "books per genre" by a
+// catalogue scan with the same comma split and case folding vs FacetIndex,
+// plus the one-off build cost and the cost of keeping counts on a loan.
+#include "BookStore.hpp"
+#include "FacetIndex.hpp"
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+template <class F>
+static double millis(int reps, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / reps;
+}
+
+// Calls fn for each normalized comma-separated value of text
+template <class F>
+static void eachValue(std::string_view text, std::string& scratch, F fn) {
+    while (true) {
+        size_t comma = text.find(',');
+        FacetIndex::normalize(text.substr(0, comma), scratch);
+        if (!scratch.empty()) fn(scratch);
+        if (comma == std::string_view::npos) return;
+        text.remove_prefix(comma + 1);
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 500000;
+    static const char* genres[] = {"Science Fiction", "Historical Fiction, Romance", "Biography", "Philosophy",
+                                   "Computer Science", "poetry, epic", "Mystery, Crime", "Travel"};
+    BookStore books;
+    books.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        books.add(Book(std::to_string(i + 1), "Title " + std::to_string(i), "Author " + std::to_string(i % 20000),
+                       genres[i % 8], 0));
+        if (i % 3 == 0) books.get(static_cast<BookHandle>(i)).borrowBook("member", 7);
+    }
+
+    FacetIndex facets(books);
+    double build = millis(1, [&]() {
+        for (auto it = books.begin(); it != books.end(); ++it) facets.add(it.handle());
+    });
+
+    std::string scratch;
+    size_t scanAvailable = 0;
+    double scanOne = millis(3, [&]() {
+        scanAvailable = 0;
+        for (const Book& b : books)
+            eachValue(b.getGenre(), scratch, [&](const std::string& v) {
+                if (v == "romance" && !b.getIsBorrowed()) scanAvailable++;
+            });
+    });
+    FacetCount one;
+    double indexOne = millis(1000, [&]() { facets.count(Facet::Genre, "Romance", one); });
+
+    std::map<std::string, size_t> scanned;
+    double scanAll = millis(3, [&]() {
+        scanned.clear();
+        for (const Book& b : books) eachValue(b.getGenre(), scratch, [&](const std::string& v) { scanned[v]++; });
+    });
+    size_t values = 0;
+    double indexAll = millis(1000, [&]() { values = facets.counts(Facet::Genre).size(); });
+
+    double loan = millis(1, [&]() {
+        for (size_t i = 0; i < count; i += 3) {
+            facets.setAvailable(static_cast<BookHandle>(i), true);
+            facets.setAvailable(static_cast<BookHandle>(i), false);
+        }
+    }) * 1e6 / (2 * ((count + 2) / 3));
+
+    printf("books: %zu  index build: %.1f ms  count update per loan change: %.0f ns\n", count, build, loan);
+    printf("%-26s %12s %12s %9s\n", "query", "scan ms", "index ms", "speedup");
+    printf("%-26s %12.3f %12.5f %8.0fx  (%zu = %zu)\n", "available in genre", scanOne, indexOne, scanOne / indexOne,
+           scanAvailable, one.available);
+    printf("%-26s %12.3f %12.5f %8.0fx  (%zu = %zu values)\n", "counts per genre", scanAll, indexAll,
+           scanAll / indexAll, scanned.size(), values);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Misspelt queries on a synthetic catalogue: the lowercase substring scan
+// the exact search started from (which finds nothing for a typo), a
+// brute-force edit-distance scan of every title and author word, and
+// FuzzyIndex, plus the index's build cost.
+#include "BookStore.hpp"
+#include "FuzzyIndex.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+static const char* words[] = {
+    "shadow", "river", "empire", "garden", "winter", "silent", "crown", "storm",
+    "glass", "hunter", "ember", "ocean", "letter", "forest", "night", "stone",
+    "mirror", "queen", "dragon", "island", "harbor", "secret", "golden", "thief",
+    "harry", "potter", "hobbit", "return", "kingdom", "wizard", "chamber", "prisoner"};
+static const char* surnames[] = {
+    "Rowling", "Tolkien", "Riordan", "Austen", "Orwell", "Herbert", "Le Guin",
+    "Pratchett", "Gaiman", "Atwood", "Murakami", "Christie", "Asimov", "Clarke"};
+
+template <class F>
+static double millis(int reps, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / reps;
+}
+
+static std::string lower(std::string_view s) {
+    std::string r(s);
+    std::transform(r.begin(), r.end(), r.begin(), ::tolower);
+    return r;
+}
+
+// Lowercase words of s, split on anything but letters and digits
+static void split(std::string_view s, std::vector<std::string>& out) {
+    out.clear();
+    std::string current;
+    for (unsigned char c : s) {
+        if (std::isalnum(c)) current += static_cast<char>(std::tolower(c));
+        else if (!current.empty()) out.push_back(std::move(current)), current.clear();
+    }
+    if (!current.empty()) out.push_back(current);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::mt19937 rng(7);
+    BookStore books;
+    books.reserve(n);
+    for (size_t i = 1; i <= n; i++) {
+        std::string title = std::string(words[rng() % 32]) + " " + words[rng() % 32] + " " +
+                            words[rng() % 32] + " " + std::to_string(rng() % 100000);
+        std::string author = std::string("Author") + std::to_string(rng() % 50000) + " " + surnames[rng() % 14];
+        books.add(Book(std::to_string(i), title, author, "Fiction", 0));
+    }
+
+    FuzzyIndex index(books);
+    double build = millis(1, [&]() {
+        for (auto it = books.begin(); it != books.end(); ++it) index.add(it.handle());
+    });
+    printf("books: %zu  words: %zu  build: %.0f ms\n\n", n, index.wordCount(), build);
+    printf("%-18s %10s %8s %12s %8s %12s %8s %8s\n", "query", "substr ms", "hits", "brute ms", "hits", "index ms",
+           "hits", "speedup");
+
+    const size_t k = 10;
+    std::vector<std::string> terms, fieldWords;
+    for (const char* query : {"Tolkein", "Harry Poter", "shadwo rivr", "drgon", "prisnor azkaban", "Pratchet"}) {
+        // Exact substring of title or author, as the console search used to do
+        std::string needle = lower(query);
+        size_t substrHits = 0;
+        double substr = millis(1, [&]() {
+            substrHits = 0;
+            for (const Book& b : books)
+                if (lower(b.getTitle()).find(needle) != std::string::npos ||
+                    lower(b.getAuthor()).find(needle) != std::string::npos)
+                    substrHits++;
+        });
+
+        // Every word of every book against every query word; counts books
+        // with a word within the budget for each query word
+        split(query, terms);
+        size_t bruteHits = 0;
+        double brute = millis(1, [&]() {
+            bruteHits = 0;
+            for (const Book& b : books) {
+                split(std::string(b.getTitle()) + " " + std::string(b.getAuthor()), fieldWords);
+                bool all = true;
+                for (const std::string& t : terms) {
+                    int limit = FuzzyIndex::maxEdits(t.size());
+                    bool any = false;
+                    for (const std::string& w : fieldWords)
+                        if (FuzzyIndex::distance(t, w, limit) <= limit) {
+                            any = true;
+                            break;
+                        }
+                    all = all && any;
+                }
+                if (all) bruteHits++;
+            }
+        });
+
+        std::vector<FuzzyResult> top;
+        double viaIndex = millis(5, [&]() { top = index.search(query, k); });
+        printf("%-18s %10.1f %8zu %12.1f %8zu %12.3f %8zu %7.0fx\n", query, substr, substrHits, brute, bruteHits,
+               viaIndex, top.size(), brute / viaIndex);
+        if (!top.empty()) {
+            const Book& best = books.get(top[0].book);
+            printf("    best %.2f: %s / %s\n", top[0].score, std::string(best.getTitle()).c_str(),
+                   std::string(best.getAuthor()).c_str());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Borrowing history: list of "timestamp|action|title" strings vs HistoryLog.
+// Reports resident memory per entry and the cost of showing the newest page
+// and a one-month range. Each layout runs in its own child process.
+#include "HistoryLog.hpp"
+#include "TextScanner.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static long residentKb() {
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, rss = 0;
+    statm >> pages >> rss;
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static const time_t START = 1700000000;
+static const size_t PAGE = 20;
+
+static std::string titleOf(size_t i) {
+    return "Synthetic Title Number " + std::to_string(i % 5000);
+}
+
+template <class F>
+static double usPerCall(F fn, int calls) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++) fn();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / calls;
+}
+
+static void runStrings(size_t members, size_t entries) {
+    long before = residentKb();
+    std::vector<std::list<std::string>> histories(members);
+    for (size_t m = 0; m < members; m++)
+        for (size_t e = 0; e < entries; e++)
+            histories[m].push_back(std::to_string(START + e * 3600) + (e % 2 ? "|Returned|" : "|Borrowed|") +
+                                   titleOf(m + e / 2));
+    long kb = residentKb() - before;
+
+    // The old view: copy the list and parse every entry, as displayHistory did
+    volatile size_t sink = 0;
+    double pageUs = usPerCall([&]() {
+        std::list<std::string> copy = histories[0];
+        std::vector<std::string> page;
+        for (const auto& entry : copy) {
+            std::string_view parts[3];
+            long long t;
+            if (splitFields(entry, '|', parts, 3) == 3 && parseInt(parts[0], t)) page.emplace_back(parts[2]);
+        }
+        sink += page.size();
+    }, 200);
+    double rangeUs = usPerCall([&]() {
+        size_t hits = 0;
+        for (const auto& entry : std::list<std::string>(histories[0])) {
+            long long t;
+            std::string_view parts[1];
+            if (splitFields(entry, '|', parts, 1) && parseInt(parts[0], t) && t >= START + 86400 * 10 &&
+                t < START + 86400 * 40)
+                hits++;
+        }
+        sink += hits;
+    }, 200);
+    printf("%-22s %10.1f B/entry %12.2f us %12.2f us\n", "list<string>",
+           kb * 1024.0 / (members * entries), pageUs, rangeUs);
+}
+
+static void runColumns(size_t members, size_t entries) {
+    long before = residentKb();
+    std::vector<HistoryLog> histories(members);
+    for (size_t m = 0; m < members; m++)
+        for (size_t e = 0; e < entries; e++)
+            histories[m].append(START + e * 3600, e % 2 ? HistoryAction::Returned : HistoryAction::Borrowed,
+                                titleOf(m + e / 2));
+    long kb = residentKb() - before;
+
+    volatile size_t sink = 0;
+    double pageUs = usPerCall([&]() {
+        HistoryLog::View all = histories[0].all();
+        size_t start = all.size() > PAGE ? all.size() - PAGE : 0;
+        for (const HistoryEntry& e : all.page(start, PAGE)) sink += e.title.size();
+    }, 200000);
+    double rangeUs = usPerCall([&]() {
+        sink += histories[0].range(START + 86400 * 10, START + 86400 * 40).size();
+    }, 200000);
+    printf("%-22s %10.1f B/entry %12.2f us %12.2f us\n", "HistoryLog (columns)",
+           kb * 1024.0 / (members * entries), pageUs, rangeUs);
+}
+
+int main(int argc, char** argv) {
+    size_t members = argc > 1 ? std::stoul(argv[1]) : 2000;
+    size_t entries = argc > 2 ? std::stoul(argv[2]) : 2000;
+    printf("members: %zu  entries each: %zu\n", members, entries);
+    printf("%-22s %18s %15s %15s\n", "layout", "resident", "newest page", "30-day range");
+    fflush(stdout);
+    for (int layout = 0; layout < 2; layout++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            if (layout == 0) runStrings(members, entries);
+            else runColumns(members, entries);
+            fflush(stdout);
+            _exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Importing books under generated IDs: the old addBook gap scan (walk the
+// catalogue parsing every ID) vs IdAllocator, then LibrarySystem::addBook
+// end to end. The scan is quadratic, so it only runs for the first books
+// and the rest is projected.
+#include "BookStore.hpp"
+#include "IdAllocator.hpp"
+#include "LibrarySystem.hpp"
+#include "TextScanner.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+template <class F>
+static double seconds(F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// addBook before the allocator
+static std::string scanForId(const BookStore& books) {
+    long long next = 1;
+    for (auto it = books.begin(); it != books.end(); ++it) {
+        long long n;
+        if (!parseInt(it->getId(), n) || n != next) break;
+        next++;
+    }
+    return std::to_string(next);
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t scanned = std::min<size_t>(count, 20000);
+
+    BookStore old;
+    double scan = seconds([&]() {
+        for (size_t i = 0; i < scanned; i++) old.add(Book(scanForId(old), "Title", "Author", "Fiction", 0));
+    });
+    double projected = scan * (double(count) / scanned) * (double(count) / scanned);
+
+    BookStore books;
+    IdAllocator ids;
+    double alloc = seconds([&]() {
+        for (size_t i = 0; i < count; i++) books.add(Book(std::to_string(ids.allocate()), "Title", "Author", "Fiction", 0));
+    });
+
+    // Remove a random tenth, then refill: each add reuses the lowest gap
+    std::mt19937 rng(3);
+    std::vector<BookHandle> victims;
+    for (size_t i = 0; i < count / 10; i++) victims.push_back(static_cast<BookHandle>(rng() % count));
+    size_t removed = 0;
+    for (BookHandle h : victims) {
+        if (!books.isLive(h)) continue;
+        ids.release(books.get(h).getId());
+        books.remove(h);
+        removed++;
+    }
+    double refill = seconds([&]() {
+        for (size_t i = 0; i < removed; i++) books.add(Book(std::to_string(ids.allocate()), "Title", "Author", "Fiction", 0));
+    });
+    bool dense = ids.allocate() == count + 1;
+
+    printf("imports: %zu\n", count);
+    printf("%-22s %10.1f ms for %zu  (projected %.0f s for %zu)\n", "gap scan", scan * 1e3, scanned, projected, count);
+    printf("%-22s %10.1f ms  %6.0f ns/book\n", "allocator", alloc * 1e3, alloc * 1e9 / count);
+    printf("%-22s %10.1f ms  %6.0f ns/book  (%zu gaps refilled, dense: %s)\n", "allocator after removes",
+           refill * 1e3, refill * 1e9 / removed, removed, dense ? "yes" : "no");
+
+    // The whole API call: allocation, indexes and the operation log
+    std::string dir = "/tmp/library_bench_ids";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    auto app = std::make_unique<LibrarySystem>(DataFormat::Text, dir, 1);
+    double api = seconds([&]() {
+        for (size_t i = 0; i < count; i++) app->addBook("Title", "Author", "Fiction");
+    });
+    printf("%-22s %10.1f ms  %6.0f ns/book\n", "addBook()", api * 1e3, api * 1e9 / count);
+    app.reset();
+    std::system(("rm -rf " + dir).c_str());
+    return 0;
+}
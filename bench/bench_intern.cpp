@@ -0,0 +1,88 @@
+// Catalogue of std::string fields (the old Book layout) vs interned Book.
+// Reports resident memory per book and the time of a full catalogue scan
+// (count the books of one author, as a filter over displayAllBooks would).
+// Each layout runs in its own child process.
+#include "Book.hpp"
+#include "StringPool.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static long residentKb() {
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, rss = 0;
+    statm >> pages >> rss;
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Same fields and by-value getters as Book before interning
+struct StringBook {
+    std::string id, title, author, genre;
+    bool isBorrowed;
+    time_t dueDate;
+    std::string borrowedByMemberId;
+    ReservationQueue reservationQueue;
+
+    StringBook(std::string id, std::string title, std::string author, std::string genre, time_t dueDate)
+        : id(std::move(id)), title(std::move(title)), author(std::move(author)), genre(std::move(genre)),
+          isBorrowed(false), dueDate(dueDate) {}
+    std::string getAuthor() const { return author; }
+};
+
+static std::string titleOf(size_t i) { return "The Collected Works of Synthetic Volume " + std::to_string(i); }
+static std::string authorOf(size_t i) { return "Author Surname " + std::to_string(i % 20000); }
+static std::string genreOf(size_t i) {
+    static const char* genres[] = {"Science Fiction", "Historical Fiction", "Biography", "Philosophy",
+                                   "Computer Science", "Poetry", "Mystery", "Travel"};
+    return genres[i % 8];
+}
+
+template <class F>
+static double msPerCall(F fn, int calls) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++) fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / calls;
+}
+
+template <class B>
+static void run(const char* name, size_t count) {
+    long before = residentKb();
+    std::vector<B> books;
+    books.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        books.emplace_back(std::to_string(i + 1), titleOf(i), authorOf(i), genreOf(i), 0);
+    }
+    long kb = residentKb() - before;
+
+    volatile size_t sink = 0;
+    std::string query = authorOf(1234);
+    double scanMs = msPerCall([&]() {
+        size_t hits = 0;
+        for (const B& b : books) hits += b.getAuthor() == query;
+        sink += hits;
+    }, 10);
+    printf("%-16s %10.1f B/book %12.2f ms\n", name, kb * 1024.0 / count, scanMs);
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    printf("books: %zu\n", count);
+    printf("%-16s %17s %15s\n", "layout", "resident", "author scan");
+    fflush(stdout);
+    for (int layout = 0; layout < 2; layout++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            if (layout == 0) run<StringBook>("std::string", count);
+            else run<Book>("interned Book", count);
+            fflush(stdout);
+            _exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Text import scaling: LibrarySystem start-up with 1..N parser threads.
+// Every run saves on exit, so the files written by each run must match the
+// first run byte for byte (the parallel load is identical to the sequential one).
+#include "LibrarySystem.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void writeTextData(const std::string& dir, size_t books, size_t members) {
+    std::ofstream b(dir + "/books.txt");
+    for (size_t i = 1; i <= books; i++) {
+        bool borrowed = i % 5 == 0;
+        b << i << "|Synthetic Title " << i << "|Author " << (i % 20000) << "|"
+          << (i % 3 ? "Fiction" : "fiction, gods") << "|" << borrowed << "|1768100000|"
+          << (borrowed ? std::to_string(i % members + 1) : "") << "|"
+          << (i % 50 == 0 ? "2,3" : "") << "\n";
+    }
+    std::ofstream u(dir + "/users.txt");
+    u << "Librarian|admin|Admin|admin@library.com\n";
+    for (size_t i = 1; i <= members; i++) {
+        u << "Member|" << i << "|Member " << i << "|m" << i << "@mail.com|";
+        for (int h = 0; h < 4; h++) u << (h ? "," : "") << 1768100000 + h << "|Borrowed|Synthetic Title " << (i + h);
+        u << "\n";
+    }
+}
+
+static std::string readAll(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+int main(int argc, char** argv) {
+    size_t books = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t members = argc > 2 ? std::stoul(argv[2]) : books / 10;
+    unsigned maxThreads = argc > 3 ? std::stoul(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    std::string dir = "/tmp/library_bench_load";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    writeTextData(dir, books, members);
+
+    // Normalise the files once (adds the checkpoint lines) so later saves compare equal
+    std::make_unique<LibrarySystem>(DataFormat::Text, dir, 1).reset();
+    std::string expectBooks = readAll(dir + "/books.txt");
+    std::string expectUsers = readAll(dir + "/users.txt");
+
+    printf("books: %zu  members: %zu\n", books, members);
+    double baseline = 0;
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        auto t0 = std::chrono::steady_clock::now();
+        auto app = std::make_unique<LibrarySystem>(DataFormat::Text, dir, threads);
+        double ms = msSince(t0);
+        app.reset();
+        if (threads == 1) baseline = ms;
+        bool same = readAll(dir + "/books.txt") == expectBooks && readAll(dir + "/users.txt") == expectUsers;
+        printf("%2u threads %10.1f ms  %5.2fx  %s\n", threads, ms, baseline / ms, same ? "identical" : "MISMATCH");
+        if (threads * 2 > maxThreads && threads != maxThreads) threads = maxThreads / 2;
+    }
+
+    std::system(("rm -rf " + dir).c_str());
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Lookup latency: linear std::list walk vs HashIndex, as the collection grows
+#include "HashIndex.hpp"
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Record {
+    std::string id;
+    std::string payload;
+};
+
+static volatile size_t sink;
+
+int main() {
+    const size_t sizes[] = {1000, 10000, 100000, 500000};
+    std::mt19937 rng(42);
+
+    printf("%10s %16s %16s\n", "records", "list ns/lookup", "index ns/lookup");
+    for (size_t n : sizes) {
+        std::list<Record> records;
+        HashIndex<Record*> index;
+        for (size_t i = 1; i <= n; i++) {
+            records.push_back({std::to_string(i), "payload"});
+            index.insert(records.back().id, &records.back());
+        }
+
+        std::vector<std::string> queries;
+        std::uniform_int_distribution<size_t> pick(1, n);
+        for (int i = 0; i < 2000; i++) queries.push_back(std::to_string(pick(rng)));
+
+        // Linear walk; fewer queries for large n so the run stays short
+        size_t listQueries = n > 100000 ? 50 : 500;
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < listQueries; q++) {
+            for (auto& r : records) {
+                if (r.id == queries[q]) { sink += r.payload.size(); break; }
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+
+        size_t indexQueries = 0;
+        for (int rep = 0; rep < 500; rep++) {
+            for (auto& q : queries) {
+                Record* const* r = index.find(q);
+                if (r) sink += (*r)->payload.size();
+                indexQueries++;
+            }
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        double listNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / listQueries;
+        double indexNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / indexQueries;
+        printf("%10zu %16.1f %16.1f\n", n, listNs, indexNs);
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+// Cost of the latency instrumentation: a bare ScopedTimer with metrics on
+// and switched off at run time, then hot API calls (findBook through
+// borrow/return, indexed search) both ways. Also checks the histogram's
+// quantiles against exact ones from sorted samples.
+#include "LibrarySystem.hpp"
+#include "Metrics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static void writeTextData(const std::string& dir, size_t books, size_t members) {
+    std::ofstream b(dir + "/books.txt");
+    for (size_t i = 1; i <= books; i++)
+        b << i << "|Synthetic Title " << i << "|Author " << (i % 2000) << "|Fiction|0|0||\n";
+    std::ofstream u(dir + "/users.txt");
+    u << "Librarian|admin|Admin|admin@library.com\n";
+    for (size_t i = 1; i <= members; i++) u << "Member|" << i << "|Member " << i << "|m" << i << "@mail.com|\n";
+}
+
+template <class F>
+static double nsPer(size_t calls, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / calls;
+}
+
+// Best of three, alternating on and off so drift hits both alike
+template <class F>
+static void compare(const char* name, size_t calls, F fn) {
+    double on = 1e18, off = 1e18;
+    for (int round = 0; round < 3; round++) {
+        Metrics::global().setEnabled(true);
+        on = std::min(on, nsPer(calls, fn));
+        Metrics::global().setEnabled(false);
+        off = std::min(off, nsPer(calls, fn));
+    }
+    Metrics::global().setEnabled(true);
+    printf("%-22s %10.1f ns off %10.1f ns on  %+7.1f ns  (%+.1f%%)\n", name, off, on, on - off,
+           (on - off) * 100 / off);
+}
+
+int main(int argc, char** argv) {
+    size_t books = argc > 1 ? std::stoul(argv[1]) : 200000;
+    size_t calls = argc > 2 ? std::stoul(argv[2]) : 100000;
+    size_t members = 10000;
+
+    compare("ScopedTimer", calls * 10, [&]() {
+        for (size_t i = 0; i < calls * 10; i++) ScopedTimer timer(Metrics::Op::FindBook);
+    });
+
+    std::string dir = "/tmp/library_bench_metrics";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    writeTextData(dir, books, members);
+    auto app = std::make_unique<LibrarySystem>(DataFormat::Text, dir, 1);
+    app->search("synthetic", 0, 1); // build the search index outside the timings
+
+    std::vector<std::string> bookIds, memberIds;
+    for (size_t i = 0; i < calls; i++) {
+        bookIds.push_back(std::to_string(i % books + 1));
+        memberIds.push_back(std::to_string(i % members + 1));
+    }
+    compare("borrow + return", calls, [&]() {
+        for (size_t i = 0; i < calls; i++) {
+            app->borrow(memberIds[i], bookIds[i]);
+            app->returnBook(memberIds[i], bookIds[i]);
+        }
+    });
+    size_t hits = 0;
+    compare("search", calls / 10, [&]() {
+        for (size_t i = 0; i < calls / 10; i++) hits += app->search("author " + std::to_string(i % 2000), 0, 20).size();
+    });
+    app.reset();
+    std::system(("rm -rf " + dir).c_str());
+
+    // Log-normal latencies, as a real operation's tend to be
+    Metrics::global().reset();
+    std::mt19937 rng(7);
+    std::lognormal_distribution<double> latency(std::log(20000.0), 1.0);
+    std::vector<uint64_t> samples(1000000);
+    for (uint64_t& ns : samples) {
+        ns = static_cast<uint64_t>(latency(rng));
+        Metrics::global().record(Metrics::Op::Search, ns);
+    }
+    std::sort(samples.begin(), samples.end());
+    Metrics::Summary s = Metrics::global().summary(Metrics::Op::Search);
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    const double estimates[] = {s.p50Ms, s.p90Ms, s.p99Ms, s.p999Ms};
+    printf("histogram accuracy over %zu samples:\n", samples.size());
+    for (int q = 0; q < 4; q++) {
+        double exact = samples[static_cast<size_t>(std::ceil(quantiles[q] * samples.size())) - 1] / 1e6;
+        printf("  p%-6g exact %9.4f ms  histogram %9.4f ms  %+.2f%%\n", quantiles[q] * 100, exact, estimates[q],
+               (estimates[q] - exact) * 100 / exact);
+    }
+    return hits == 0;
+}
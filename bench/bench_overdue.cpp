@@ -0,0 +1,65 @@
+// Overdue loans as of a date: a sweep of the whole catalogue comparing
+// due dates vs DueIndex::dueBefore(), at several overdue fractions, plus
+// the cost of keeping the index current on borrow/return.
+#include "BookStore.hpp"
+#include "DueIndex.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+template <class F>
+static double millis(int reps, F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() / reps;
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 500000;
+    size_t loans = count / 4;
+    const time_t now = 1767225600;
+    const time_t spread = 60 * 24 * 3600; // due dates over 60 days
+
+    BookStore books;
+    DueIndex index;
+    books.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        books.add(Book(std::to_string(i + 1), "Title " + std::to_string(i), "Author", "Fiction", now));
+    std::vector<BookHandle> borrowed;
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < loans; i++) {
+        BookHandle h = static_cast<BookHandle>(i * 7919 % count);
+        if (books.get(h).getIsBorrowed()) continue;
+        time_t due = now + static_cast<time_t>(i * 104729 % spread);
+        books.get(h).borrowBook("member", 0, due);
+        index.add(h, due);
+        borrowed.push_back(h);
+    }
+    double addNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / borrowed.size();
+    printf("books: %zu  loans: %zu  (borrow incl. index: %.0f ns)\n", count, index.size(), addNs);
+    printf("%9s %9s %12s %12s %8s\n", "overdue", "loans", "scan ms", "index ms", "speedup");
+
+    for (double fraction : {0.001, 0.01, 0.1, 0.5}) {
+        time_t asOf = now + static_cast<time_t>(spread * fraction);
+        size_t scanned = 0, indexed = 0;
+        double scan = millis(5, [&]() {
+            std::vector<DueLoan> found;
+            for (auto it = books.begin(); it != books.end(); ++it)
+                if (it->getIsBorrowed() && it->getDueDate() < asOf) found.push_back(DueLoan{it->getDueDate(), it.handle()});
+            std::sort(found.begin(), found.end(), [](const DueLoan& a, const DueLoan& b) { return a.due < b.due; });
+            scanned = found.size();
+        });
+        double viaIndex = millis(5, [&]() { indexed = index.dueBefore(asOf).size(); });
+        if (scanned != indexed) printf("mismatch: %zu vs %zu\n", scanned, indexed);
+        printf("%8.1f%% %9zu %12.3f %12.3f %7.0fx\n", fraction * 100, indexed, scan, viaIndex, scan / viaIndex);
+    }
+
+    // Returns pull entries from the middle of the heap
+    t0 = std::chrono::steady_clock::now();
+    for (BookHandle h : borrowed) index.remove(h);
+    double removeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / borrowed.size();
+    printf("index remove: %.0f ns per return\n", removeNs);
+    return 0;
+}
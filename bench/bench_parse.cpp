@@ -0,0 +1,171 @@
+// Tokenizer throughput on books.txt and users.txt: getline/stringstream/stoll
+// vs TextScanner
+#include "TextScanner.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+
+static double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void writeBooks(const std::string& path, size_t targetBytes) {
+    std::ofstream out(path);
+    std::string line;
+    for (size_t i = 1, written = 0; written < targetBytes; i++) {
+        bool borrowed = i % 5 == 0;
+        line = std::to_string(i) + "|Synthetic Title " + std::to_string(i) + "|Author " +
+               std::to_string(i % 20000) + "|" + (i % 3 ? "Fiction" : "fiction, gods") + "|" +
+               (borrowed ? "1" : "0") + "|" + std::to_string(1768100000 + i % 86400) + "|" +
+               (borrowed ? std::to_string(i % 100000) : "") + "|" + (i % 50 == 0 ? "2,3" : "") + "\n";
+        out << line;
+        written += line.size();
+    }
+}
+
+// Members with four history entries each, as the loaders read them
+static void writeUsers(const std::string& path, size_t targetBytes) {
+    std::ofstream out(path);
+    std::string line;
+    out << "Librarian|admin|Admin|admin@library.com\n";
+    for (size_t i = 1, written = 0; written < targetBytes; i++) {
+        line = "Member|" + std::to_string(i) + "|Member " + std::to_string(i) + "|m" + std::to_string(i) +
+               "@mail.com|";
+        for (size_t h = 0; h < 4; h++) {
+            if (h) line += ',';
+            line += std::to_string(1768100000 + i + h) + (h % 2 ? "|Returned|" : "|Borrowed|") +
+                    "Synthetic Title " + std::to_string(i + h / 2);
+        }
+        line += '\n';
+        out << line;
+        written += line.size();
+    }
+}
+
+// The loader before the scanner: one stringstream and a vector of strings per line
+static long long parseStreams(const std::string& path, size_t& lines) {
+    std::ifstream in(path);
+    std::string line;
+    long long sum = 0;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::stringstream ss(line);
+        std::string segment;
+        std::vector<std::string> seglist;
+        while (std::getline(ss, segment, '|')) seglist.push_back(segment);
+        if (seglist.size() >= 7) {
+            sum += std::stoll(seglist[5]) + seglist[1].size();
+            lines++;
+        }
+    }
+    return sum;
+}
+
+// The user loader before the scanner: the history kept as strings, then
+// each entry split again for its timestamp
+static long long parseUserStreams(const std::string& path, size_t& lines) {
+    std::ifstream in(path);
+    std::string line;
+    long long sum = 0;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        std::stringstream ss(line);
+        std::string type, id, name, email, history;
+        std::getline(ss, type, '|');
+        std::getline(ss, id, '|');
+        std::getline(ss, name, '|');
+        std::getline(ss, email, '|');
+        sum += name.size();
+        if (type == "Member" && std::getline(ss, history)) {
+            std::stringstream entries(history);
+            std::string entry;
+            while (std::getline(entries, entry, ',')) {
+                std::stringstream parts(entry);
+                std::string time;
+                if (std::getline(parts, time, '|')) sum += std::stoll(time);
+            }
+        }
+        lines++;
+    }
+    return sum;
+}
+
+static long long parseUserScanner(const std::string& path, size_t& lines) {
+    MappedFile in;
+    if (!in.open(path)) return 0;
+    LineReader reader(in.view());
+    std::string_view line, type, id, name, email, entry, time;
+    long long sum = 0, value;
+    while (reader.next(line)) {
+        if (line.empty()) continue;
+        FieldSplitter fields(line, '|');
+        if (!fields.next(type) || !fields.next(id) || !fields.next(name) || !fields.next(email)) continue;
+        sum += name.size();
+        if (type == "Member") {
+            FieldSplitter entries(fields.rest(), ',');
+            while (entries.next(entry)) {
+                FieldSplitter parts(entry, '|');
+                if (parts.next(time) && parseInt(time, value)) sum += value;
+            }
+        }
+        lines++;
+    }
+    return sum;
+}
+
+static long long parseScanner(const std::string& path, size_t& lines) {
+    MappedFile in;
+    if (!in.open(path)) return 0;
+    LineReader reader(in.view());
+    std::string_view line, fields[8];
+    long long sum = 0, due;
+    while (reader.next(line)) {
+        if (line.empty()) continue;
+        if (splitFields(line, '|', fields, 8) >= 7 && parseInt(fields[5], due)) {
+            sum += due + fields[1].size();
+            lines++;
+        }
+    }
+    return sum;
+}
+
+template <typename Streams, typename Scanner>
+static void compare(const char* name, const std::string& path, Streams streams, Scanner scanner) {
+    struct stat st;
+    double mib = stat(path.c_str(), &st) == 0 ? st.st_size / 1048576.0 : 0;
+
+    // Warm the page cache so both runs read from memory
+    size_t lines = 0;
+    scanner(path, lines);
+
+    printf("%s: %.1f MiB\n", name, mib);
+    lines = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    long long a = streams(path, lines);
+    double s = secondsSince(t0);
+    printf("  %-26s %10.1f MiB/s  (%zu lines)\n", "getline + stringstream", mib / s, lines);
+
+    lines = 0;
+    t0 = std::chrono::steady_clock::now();
+    long long b = scanner(path, lines);
+    s = secondsSince(t0);
+    printf("  %-26s %10.1f MiB/s  (%zu lines)\n", "mmap + TextScanner", mib / s, lines);
+
+    if (a != b) printf("  checksum mismatch: %lld vs %lld\n", a, b);
+    std::remove(path.c_str());
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 256;
+    std::string books = "/tmp/library_bench_parse_books.txt";
+    std::string users = "/tmp/library_bench_parse_users.txt";
+    writeBooks(books, megabytes << 20);
+    compare("books.txt", books, parseStreams, parseScanner);
+    writeUsers(users, megabytes << 20);
+    compare("users.txt", users, parseUserStreams, parseUserScanner);
+    return 0;
+}
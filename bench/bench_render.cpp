@@ -0,0 +1,85 @@
+// Catalogue listing: the old per-cell formatCell()/formatDate() and <<
+// chains vs TableWriter, for every book of a synthetic catalogue written to
+// /dev/null (so the cost is formatting, not the terminal).
+#include "Book.hpp"
+#include "TableWriter.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// The console's formatting before TableWriter
+static std::string formatCell(std::string_view text, size_t width) {
+    if (text.length() > width) return std::string(text.substr(0, width - 3)) + "...";
+    return std::string(text) + std::string(width - text.length(), ' ');
+}
+
+static std::string formatDate(time_t t) {
+    struct tm* timeInfo = localtime(&t);
+    if (!timeInfo) return "Unknown";
+    char buffer[20];
+    strftime(buffer, sizeof(buffer), "%b %d %Y", timeInfo);
+    return std::string(buffer);
+}
+
+static void oldListing(std::ostream& out, const std::vector<Book>& books) {
+    out << std::string(115, '-') << "\n";
+    out << formatCell("ID", 8) << " | " << formatCell("Title", 30) << " | " << formatCell("Author", 20) << " | "
+        << formatCell("Genre", 15) << " | " << formatCell("Due Date", 15) << " | " << "Borrower ID\n";
+    out << std::string(115, '-') << "\n";
+    for (const auto& b : books) {
+        std::string dateStr = formatDate(b.getDueDate());
+        out << formatCell(b.getId(), 8) << " | " << formatCell(b.getTitle(), 30) << " | "
+            << formatCell(b.getAuthor(), 20) << " | " << formatCell(b.getGenre(), 15) << " | "
+            << formatCell(dateStr, 15) << " | "
+            << (b.getBorrowedById().empty() ? "N/A" : b.getBorrowedById()) << "\n";
+    }
+    out << std::string(115, '-') << "\n";
+}
+
+static void newListing(std::ostream& out, const std::vector<Book>& books, TableFormat format) {
+    TableWriter table(out, format,
+                      {{"ID", 8}, {"Title", 30}, {"Author", 20}, {"Genre", 15}, {"Due Date", 15}, {"Borrower ID", 0}},
+                      115);
+    for (const Book& b : books) {
+        table.cell(b.getId());
+        table.cell(b.getTitle());
+        table.cell(b.getAuthor());
+        table.cell(b.getGenre());
+        table.dateCell(b.getDueDate());
+        table.cell(b.getBorrowedById().empty() ? "N/A" : b.getBorrowedById());
+        table.endRow();
+    }
+}
+
+template <class F>
+static double seconds(F fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 500000;
+    std::vector<Book> books;
+    books.reserve(count);
+    time_t base = 1767225600; // dates spread over about a year
+    for (size_t i = 0; i < count; i++) {
+        books.emplace_back(std::to_string(i + 1), "The Collected Works of Synthetic Volume " + std::to_string(i),
+                           "Author Surname " + std::to_string(i % 20000), "Fiction", base + (time_t)(i * 7919 % 31536000));
+        if (i % 3 == 0) books.back().borrowBook(std::to_string(i % 5000), 7);
+    }
+
+    std::ofstream out("/dev/null");
+    double old = seconds([&]() { oldListing(out, books); });
+    double text = seconds([&]() { newListing(out, books, TableFormat::Text); });
+    double tsv = seconds([&]() { newListing(out, books, TableFormat::Tsv); });
+    double json = seconds([&]() { newListing(out, books, TableFormat::Json); });
+    printf("rows: %zu\n", count);
+    printf("%-14s %9.1f ms %10.0f rows/s\n", "formatCell", old * 1000, count / old);
+    printf("%-14s %9.1f ms %10.0f rows/s %6.1fx\n", "table text", text * 1000, count / text, old / text);
+    printf("%-14s %9.1f ms %10.0f rows/s\n", "table tsv", tsv * 1000, count / tsv);
+    printf("%-14s %9.1f ms %10.0f rows/s\n", "table json", json * 1000, count / json);
+    return 0;
+}
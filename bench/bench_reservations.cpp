@@ -0,0 +1,71 @@
+// Reservation queue contention: P threads reserve the same book while one
+// thread hands copies out, lock-free ReservationQueue vs a mutex + deque
+#include "ReservationQueue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct LockedQueue {
+    std::mutex mtx;
+    std::deque<std::string> items;
+
+    void push(std::string memberId) {
+        std::lock_guard<std::mutex> lock(mtx);
+        items.push_back(std::move(memberId));
+    }
+    bool pop(std::string& memberId) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (items.empty()) return false;
+        memberId = std::move(items.front());
+        items.pop_front();
+        return true;
+    }
+};
+
+// Returns million operations (pushes + pops) per second
+template <class Queue>
+static double run(unsigned producers, size_t perProducer) {
+    Queue queue;
+    size_t total = producers * perProducer;
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::thread consumer([&]() {
+        std::string memberId;
+        size_t popped = 0;
+        while (popped < total) {
+            if (queue.pop(memberId)) popped++;
+            else std::this_thread::yield();
+        }
+    });
+    std::vector<std::thread> threads;
+    for (unsigned p = 0; p < producers; p++) {
+        threads.emplace_back([&, p]() {
+            // Member IDs long enough to defeat the small-string buffer
+            std::string prefix = "member-with-a-long-id-" + std::to_string(p) + "-";
+            for (size_t i = 0; i < perProducer; i++) queue.push(prefix + std::to_string(i));
+        });
+    }
+    for (auto& t : threads) t.join();
+    consumer.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return 2.0 * total / seconds / 1e6;
+}
+
+int main(int argc, char** argv) {
+    size_t perProducer = argc > 1 ? std::stoul(argv[1]) : 200000;
+    unsigned maxProducers = argc > 2 ? std::stoul(argv[2]) : 16;
+
+    printf("%zu reservations per producer, one consumer\n", perProducer);
+    printf("%10s %18s %18s\n", "producers", "lock-free Mops/s", "mutex Mops/s");
+    for (unsigned producers = 1; producers <= maxProducers; producers *= 2) {
+        double lockFree = run<ReservationQueue>(producers, perProducer);
+        double locked = run<LockedQueue>(producers, perProducer);
+        printf("%10u %18.2f %18.2f\n", producers, lockFree, locked);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Query latency: lowercase substring scan vs SearchIndex on a synthetic catalogue
+#include "SearchIndex.hpp"
+#include "BookStore.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+
+static const char* words[] = {
+    "shadow", "river", "empire", "garden", "winter", "silent", "crown", "storm",
+    "glass", "hunter", "ember", "ocean", "letter", "forest", "night", "stone",
+    "mirror", "queen", "dragon", "island", "harbor", "secret", "golden", "thief"};
+static const char* surnames[] = {
+    "Rowling", "Tolkien", "Riordan", "Austen", "Orwell", "Herbert", "Le Guin",
+    "Pratchett", "Gaiman", "Atwood", "Murakami", "Christie", "Asimov", "Clarke"};
+static const char* genres[] = {"Fiction", "fiction, gods", "physics", "history", "poetry", "fantasy"};
+
+static std::string lower(std::string_view s) {
+    std::string r(s);
+    std::transform(r.begin(), r.end(), r.begin(), ::tolower);
+    return r;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    std::mt19937 rng(7);
+    BookStore books;
+    for (size_t i = 1; i <= n; i++) {
+        std::string title = std::string(words[rng() % 24]) + " " + words[rng() % 24] + " " +
+                            words[rng() % 24] + " " + std::to_string(rng() % 100000);
+        std::string author = std::string("Author") + std::to_string(rng() % 50000) + " " + surnames[rng() % 14];
+        books.add(Book(std::to_string(i), title, author, genres[rng() % 6], 0));
+    }
+
+    SearchIndex index(books);
+    auto t0 = std::chrono::steady_clock::now();
+    for (auto it = books.begin(); it != books.end(); ++it) index.add(it.handle());
+    auto t1 = std::chrono::steady_clock::now();
+    printf("books: %zu  terms: %zu  build: %.0f ms\n\n", n, index.termCount(),
+           std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+    const char* queries[] = {"author4217", "shadow river 4217", "42178", "glass drag", "herbert ocean 9"};
+    printf("%-22s %10s %14s %14s\n", "query", "results", "scan ms", "index ms");
+    for (const char* q : queries) {
+        std::string ql = lower(q);
+        auto s0 = std::chrono::steady_clock::now();
+        size_t scanHits = 0;
+        for (const auto& b : books) {
+            if (lower(b.getId()).find(ql) != std::string::npos ||
+                lower(b.getTitle()).find(ql) != std::string::npos ||
+                lower(b.getAuthor()).find(ql) != std::string::npos ||
+                lower(b.getGenre()).find(ql) != std::string::npos)
+                scanHits++;
+        }
+        auto s1 = std::chrono::steady_clock::now();
+        const int reps = 20;
+        size_t hits = 0;
+        for (int r = 0; r < reps; r++) hits = index.search(q).size();
+        auto s2 = std::chrono::steady_clock::now();
+        (void)scanHits;
+        printf("%-22s %10zu %14.2f %14.3f\n", q, hits,
+               std::chrono::duration<double, std::milli>(s1 - s0).count(),
+               std::chrono::duration<double, std::milli>(s2 - s1).count() / reps);
+    }
+    return 0;
+}
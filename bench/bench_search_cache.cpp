@@ -0,0 +1,87 @@
+// A guest kiosk: a few hundred popular queries, repeated with a skewed
+// (Zipf-like) popularity, interleaved with borrows, returns and the odd
+// new book. Runs the same call sequence with the search cache off and on
+// and reports searches/s, latency percentiles and the hit rate.
+#include "CatalogueGenerator.hpp"
+#include "LibrarySystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+struct Run {
+    double searchesPerSecond, p50Us, p99Us;
+    SearchCacheStats cache;
+};
+
+static Run run(const CatalogueSpec& spec, const std::vector<std::string>& queries, size_t searches,
+               size_t cacheBytes) {
+    std::string dir = "/tmp/library_bench_search_cache";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    generateCatalogue(dir, spec);
+    auto app = std::make_unique<LibrarySystem>(DataFormat::Text, dir, 1);
+    app->setSearchCacheCapacity(cacheBytes);
+    app->search("the", 0, 1); // build the index outside the timings
+
+    // Query i is drawn with weight 1/(i+1)
+    std::vector<double> weights;
+    for (size_t i = 0; i < queries.size(); i++) weights.push_back(1.0 / (i + 1));
+    std::discrete_distribution<size_t> popular(weights.begin(), weights.end());
+    std::mt19937 rng(11);
+
+    std::vector<double> latencies;
+    double total = 0;
+    for (size_t i = 0; i < searches; i++) {
+        const std::string& query = queries[popular(rng)];
+        auto t0 = std::chrono::steady_clock::now();
+        app->search(query, 0, 20);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        latencies.push_back(ns);
+        total += ns;
+
+        // Background traffic: loans every few searches, a new book now and then
+        std::string member = std::to_string(1 + rng() % spec.members);
+        std::string book = std::to_string(1 + rng() % spec.books);
+        if (i % 4 == 0 && app->borrow(member, book) == OpStatus::Ok) app->returnBook(member, book);
+        if (i % 500 == 0) app->addBook(queries[rng() % queries.size()] + " Revisited", "Guest Author", "Fiction");
+    }
+    std::sort(latencies.begin(), latencies.end());
+    Run r = {searches / (total / 1e9), latencies[latencies.size() / 2] / 1e3,
+             latencies[latencies.size() * 99 / 100] / 1e3, app->searchCacheStats()};
+    app.reset();
+    std::system(("rm -rf " + dir).c_str());
+    return r;
+}
+
+int main(int argc, char** argv) {
+    CatalogueSpec spec;
+    spec.books = argc > 1 ? std::stoul(argv[1]) : 100000;
+    size_t searches = argc > 2 ? std::stoul(argv[2]) : 20000;
+    size_t distinct = argc > 3 ? std::stoul(argv[3]) : 300;
+    spec.members = 10000;
+    spec.history = 0;
+
+    // Distinct queries from the catalogue's vocabulary, most popular first
+    std::vector<std::string> queries;
+    for (std::string& q : sampleQueries(spec, distinct * 4)) {
+        if (queries.size() < distinct && std::find(queries.begin(), queries.end(), q) == queries.end())
+            queries.push_back(q);
+    }
+
+    printf("books: %zu  searches: %zu over %zu queries\n", spec.books, searches, queries.size());
+    printf("%-8s %12s %10s %10s %8s %10s %8s\n", "cache", "searches/s", "p50 us", "p99 us", "hits", "invalid.",
+           "MB");
+    for (size_t bytes : {size_t(0), size_t(8) << 20}) {
+        Run r = run(spec, queries, searches, bytes);
+        uint64_t lookups = r.cache.hits + r.cache.misses;
+        printf("%-8s %12.0f %10.1f %10.1f %7.1f%% %10llu %8.2f\n", bytes ? "8 MB" : "off", r.searchesPerSecond,
+               r.p50Us, r.p99Us, lookups ? r.cache.hits * 100.0 / lookups : 0.0,
+               static_cast<unsigned long long>(r.cache.invalidations), r.cache.bytes / 1048576.0);
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Load generator for server mode: ops/sec and latency percentiles as the
+// number of concurrent client sessions grows. Runs the server in-process on
+// a Unix socket with a synthetic catalogue; clients talk over real sockets.
+#include "LibraryServer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static void writeTextData(const std::string& dir, size_t books, size_t members) {
+    std::ofstream b(dir + "/books.txt");
+    for (size_t i = 1; i <= books; i++)
+        b << i << "|Synthetic Title " << i << "|Author " << (i % 2000) << "|Fiction|0|0||\n";
+    std::ofstream u(dir + "/users.txt");
+    u << "Librarian|admin|Admin|admin@library.com\n";
+    for (size_t i = 1; i <= members; i++) u << "Member|" << i << "|Member " << i << "|m" << i << "@mail.com|\n";
+}
+
+// Blocking line-protocol client
+class Client {
+private:
+    int fd;
+    std::string pending;
+
+    bool readLine(std::string& line) {
+        size_t newline;
+        while ((newline = pending.find('\n')) == std::string::npos) {
+            char buffer[4096];
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) return false;
+            pending.append(buffer, n);
+        }
+        line = pending.substr(0, newline);
+        pending.erase(0, newline + 1);
+        return true;
+    }
+
+public:
+    explicit Client(const std::string& path) : fd(::socket(AF_UNIX, SOCK_STREAM, 0)) {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ~Client() {
+        if (fd >= 0) ::close(fd);
+    }
+    bool ok() const { return fd >= 0; }
+
+    // Sends one request and reads the whole response; returns the status line
+    std::string call(const std::string& request) {
+        std::string line = request + "\n";
+        if (::send(fd, line.data(), line.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(line.size())) return "";
+        if (!readLine(line)) return "";
+        if (line.compare(0, 3, "OK ") == 0) {
+            std::string row;
+            for (long rows = std::atol(line.c_str() + 3); rows > 0; rows--) readLine(row);
+        }
+        return line;
+    }
+};
+
+struct RunResult {
+    size_t ops = 0;
+    std::vector<double> latencies; // microseconds
+};
+
+static void runClient(const std::string& path, unsigned id, size_t books, double seconds, RunResult& out) {
+    Client client(path);
+    if (!client.ok()) return;
+    std::mt19937 rng(id);
+    std::string member = std::to_string(id + 1);
+    std::vector<std::string> mine;
+    auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    while (std::chrono::steady_clock::now() < end) {
+        // 60% search, 20% borrow, 20% return
+        unsigned pick = rng() % 10;
+        std::string request;
+        std::string book = std::to_string(rng() % books + 1);
+        if (pick < 6) request = "SEARCH author " + std::to_string(rng() % 2000);
+        else if (pick < 8 || mine.empty()) request = "BORROW " + member + " " + book;
+        else {
+            request = "RETURN " + member + " " + mine.back();
+            mine.pop_back();
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        std::string status = client.call(request);
+        out.latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+        out.ops++;
+        if (request[0] == 'B' && status == "OK 0") mine.push_back(book);
+    }
+}
+
+static double percentile(std::vector<double>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = static_cast<size_t>(p * (v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+int main(int argc, char** argv) {
+    size_t books = argc > 1 ? std::stoul(argv[1]) : 100000;
+    unsigned maxClients = argc > 2 ? std::stoul(argv[2]) : 32;
+    double seconds = argc > 3 ? std::stod(argv[3]) : 2.0;
+    std::string dir = "/tmp/library_bench_server";
+    std::string path = dir + "/server.sock";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    writeTextData(dir, books, maxClients);
+
+    auto app = std::make_unique<LibrarySystem>(DataFormat::Text, dir);
+    LibraryServer server(*app, path);
+    if (!server.start()) {
+        printf("could not listen on %s\n", path.c_str());
+        return 1;
+    }
+
+    // Every client races for the same book: exactly one borrow may succeed
+    {
+        std::vector<std::thread> racers;
+        std::atomic<int> winners(0);
+        for (unsigned c = 0; c < maxClients; c++) {
+            racers.emplace_back([&, c]() {
+                Client client(path);
+                if (client.ok() && client.call("BORROW " + std::to_string(c + 1) + " 1") == "OK 0") winners++;
+            });
+        }
+        for (auto& t : racers) t.join();
+        printf("contended borrow of one book by %u clients: %d succeeded\n", maxClients, winners.load());
+    }
+
+    printf("books: %zu  %.1f s per step  (60%% search, 20%% borrow, 20%% return)\n", books, seconds);
+    printf("%8s %12s %10s %10s\n", "clients", "ops/sec", "p50 us", "p99 us");
+    for (unsigned clients = 1; clients <= maxClients; clients *= 2) {
+        std::vector<RunResult> results(clients);
+        std::vector<std::thread> threads;
+        for (unsigned c = 0; c < clients; c++)
+            threads.emplace_back(runClient, path, c, books, seconds, std::ref(results[c]));
+        for (auto& t : threads) t.join();
+
+        size_t ops = 0;
+        std::vector<double> all;
+        for (auto& r : results) {
+            ops += r.ops;
+            all.insert(all.end(), r.latencies.begin(), r.latencies.end());
+        }
+        double p50 = percentile(all, 0.50), p99 = percentile(all, 0.99);
+        printf("%8u %12.0f %10.1f %10.1f\n", clients, ops / seconds, p50, p99);
+    }
+
+    server.stop();
+    app.reset();
+    std::system(("rm -rf " + dir).c_str());
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Full-catalogue reports while loans keep committing. Writers move a loan
+// from one book to another (so the number of borrowed books never changes)
+// and a librarian thread adds and removes books. Readers count borrowed
+// books, either the way listings used to (shared catalogue lock, each book
+// copied under its stripe lock) or from a pinned VersionedTable snapshot.
+// Reports scans/s, loan moves/s, catalogue edits/s and how many scans saw
+// a count no committed state ever had.
+#include "BookStore.hpp"
+#include "VersionedTable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const size_t STRIPES = 256;
+
+struct Catalogue {
+    BookStore books;
+    std::shared_mutex stateLock;
+    std::mutex bookLocks[STRIPES];
+    std::mutex writeLock; // serializes snapshot writers, like loansLock
+    VersionedTable<BookRecord> versions;
+    size_t loans;
+};
+
+struct Result {
+    double scans, moves, edits;
+    long torn;
+};
+
+static Result run(size_t count, int readers, int writers, bool snapshots, double seconds) {
+    Catalogue c;
+    c.books.reserve(count + 1024);
+    for (size_t i = 0; i < count; i++) {
+        c.books.add(Book(std::to_string(i + 1), "Title " + std::to_string(i), "Author", "Fiction", 0));
+        if (i % 4 == 0) c.books.get(static_cast<BookHandle>(i)).borrowBook("member", 7);
+    }
+    c.loans = (count + 3) / 4;
+    for (auto it = c.books.begin(); it != c.books.end(); ++it) c.versions.set(it.handle(), it->record());
+    std::shared_ptr<const VersionedTable<BookRecord>::Version> published = c.versions.publish();
+
+    std::atomic<bool> stop(false);
+    std::atomic<long> scans(0), moves(0), edits(0), torn(0);
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < writers; w++) {
+        threads.emplace_back([&, w]() {
+            uint32_t seed = 12345 + w;
+            while (!stop) {
+                seed = seed * 1103515245 + 12345;
+                BookHandle a = (seed >> 8) % count;
+                BookHandle b = (a + 1 + (seed >> 20) % 1000) % count;
+                std::shared_lock<std::shared_mutex> shared(c.stateLock);
+                std::mutex& first = c.bookLocks[std::min(a % STRIPES, b % STRIPES)];
+                std::mutex& second = c.bookLocks[std::max(a % STRIPES, b % STRIPES)];
+                std::unique_lock<std::mutex> l1(first);
+                std::unique_lock<std::mutex> l2;
+                if (&second != &first) l2 = std::unique_lock<std::mutex>(second);
+                Book& from = c.books.get(a);
+                Book& to = c.books.get(b);
+                if (!from.getIsBorrowed() || to.getIsBorrowed()) continue;
+                from.returnBook();
+                to.borrowBook("member", 7);
+                if (snapshots) {
+                    std::lock_guard<std::mutex> guard(c.writeLock);
+                    c.versions.set(a, from.record());
+                    c.versions.set(b, to.record());
+                    std::atomic_store(&published, c.versions.publish());
+                }
+                moves++;
+            }
+        });
+    }
+
+    // Catalogue edits need the exclusive lock, so a locked scan holds them off
+    threads.emplace_back([&]() {
+        while (!stop) {
+            std::unique_lock<std::shared_mutex> exclusive(c.stateLock);
+            BookHandle h = c.books.add(Book("extra", "Extra", "Author", "Fiction", 0));
+            if (snapshots) {
+                std::lock_guard<std::mutex> guard(c.writeLock);
+                c.versions.set(h, c.books.get(h).record());
+                c.versions.erase(h);
+                std::atomic_store(&published, c.versions.publish());
+            }
+            c.books.remove(h);
+            exclusive.unlock();
+            edits++;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&]() {
+            while (!stop) {
+                size_t borrowed = 0;
+                if (snapshots) {
+                    auto version = std::atomic_load(&published);
+                    version->forEach([&](uint32_t, const BookRecord& record) {
+                        borrowed += record.isBorrowed;
+                        return true;
+                    });
+                } else {
+                    std::shared_lock<std::shared_mutex> shared(c.stateLock);
+                    for (auto it = c.books.begin(); it != c.books.end(); ++it) {
+                        std::lock_guard<std::mutex> guard(c.bookLocks[it.handle() % STRIPES]);
+                        Book copy = *it;
+                        borrowed += copy.getIsBorrowed();
+                    }
+                }
+                if (borrowed != c.loans) torn++;
+                scans++;
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (std::thread& t : threads) t.join();
+    published.reset();
+    return Result{scans / seconds, moves / seconds, edits / seconds, torn.load()};
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    double seconds = argc > 2 ? std::stod(argv[2]) : 2.0;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    printf("books: %zu  cores: %u  %.1f s per run\n", count, cores, seconds);
+    printf("%-10s %7s %7s %10s %12s %10s %8s\n", "reads", "readers", "writers", "scans/s", "moves/s", "edits/s",
+           "torn");
+    for (int writers : {1, 4}) {
+        for (int readers : {1, 2}) {
+            for (bool snapshots : {false, true}) {
+                Result r = run(count, readers, writers, snapshots, seconds);
+                printf("%-10s %7d %7d %10.1f %12.0f %10.0f %8ld\n", snapshots ? "snapshot" : "locked", readers,
+                       writers, r.scans, r.moves, r.edits, r.torn);
+            }
+        }
+    }
+    return 0;
+}
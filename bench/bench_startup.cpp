@@ -0,0 +1,74 @@
+// Startup time: text import vs binary snapshot, plus the cost of mapping and
+// validating the snapshot on its own
+#include "LibrarySystem.hpp"
+#include "Snapshot.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+
+static double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void writeTextData(const std::string& dir, size_t books, size_t members) {
+    std::ofstream b(dir + "/books.txt");
+    for (size_t i = 1; i <= books; i++) {
+        bool borrowed = i % 5 == 0;
+        b << i << "|Synthetic Title " << i << "|Author " << (i % 20000) << "|"
+          << (i % 3 ? "Fiction" : "fiction, gods") << "|" << borrowed << "|1768100000|"
+          << (borrowed ? std::to_string(i % members + 1) : "") << "|"
+          << (i % 50 == 0 ? "2,3" : "") << "\n";
+    }
+    std::ofstream u(dir + "/users.txt");
+    u << "Librarian|admin|Admin|admin@library.com\n";
+    for (size_t i = 1; i <= members; i++) {
+        u << "Member|" << i << "|Member " << i << "|m" << i << "@mail.com|";
+        for (int h = 0; h < 4; h++) u << (h ? "," : "") << 1768100000 + h << "|Borrowed|Synthetic Title " << (i + h);
+        u << "\n";
+    }
+}
+
+static off_t fileSize(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+}
+
+int main(int argc, char** argv) {
+    size_t books = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t members = argc > 2 ? std::stoul(argv[2]) : books / 10;
+    std::string dir = "/tmp/library_bench_startup";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    writeTextData(dir, books, members);
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto text = std::make_unique<LibrarySystem>(DataFormat::Text, dir);
+    double textMs = msSince(t0);
+    text.reset();
+
+    // First binary run imports the text files and writes the snapshot on exit
+    std::make_unique<LibrarySystem>(DataFormat::Binary, dir).reset();
+
+    t0 = std::chrono::steady_clock::now();
+    auto binary = std::make_unique<LibrarySystem>(DataFormat::Binary, dir);
+    double binaryMs = msSince(t0);
+    binary.reset();
+
+    t0 = std::chrono::steady_clock::now();
+    SnapshotView view;
+    bool opened = view.open(dir + "/library.snap");
+    double mapMs = msSince(t0);
+
+    printf("books: %zu  members: %zu\n", books, members);
+    printf("text files:     %8.1f MiB\n", (fileSize(dir + "/books.txt") + fileSize(dir + "/users.txt")) / 1048576.0);
+    printf("snapshot file:  %8.1f MiB\n", fileSize(dir + "/library.snap") / 1048576.0);
+    printf("%-32s %10.1f ms\n", "text load (LibrarySystem)", textMs);
+    printf("%-32s %10.1f ms\n", "snapshot load (LibrarySystem)", binaryMs);
+    printf("%-32s %10.3f ms  (%s)\n", "snapshot mmap + validate", mapMs, opened ? "valid" : "rejected");
+
+    std::system(("rm -rf " + dir).c_str());
+    return 0;
+}
@@ -0,0 +1,85 @@
+// Catalogue scan throughput and resident memory: std::list<Book> vs BookStore.
+// Each configuration runs in its own child process so RSS is not shared.
+#include "BookStore.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static long residentKb() {
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0, rss = 0;
+    statm >> pages >> rss;
+    return rss * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static Book makeBook(size_t i) {
+    Book b(std::to_string(i), "Synthetic Title Number " + std::to_string(i),
+           "Author " + std::to_string(i % 5000), i % 3 ? "Fiction" : "physics", 0);
+    if (i % 4 == 0) b.borrowBook(std::to_string(i % 1000), 7);
+    return b;
+}
+
+template <typename Container>
+static size_t scan(const Container& books) {
+    // Loan-state sweep; getId() stays within the small-string buffer so the
+    // loop measures memory layout rather than getter copies
+    size_t acc = 0;
+    for (const Book& b : books) {
+        acc += b.getIsBorrowed() + b.getId().size() + static_cast<size_t>(b.getDueDate() & 1);
+    }
+    return acc;
+}
+
+template <typename Build>
+static void run(const char* layout, size_t n, Build build) {
+    long before = residentKb();
+    auto books = build(n);
+    long after = residentKb();
+
+    const int passes = 5;
+    size_t acc = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int p = 0; p < passes; p++) acc += scan(books);
+    auto t1 = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    printf("%-10s %9zu %14.1f %12ld %6zu\n", layout, n, n * passes / secs / 1e6, after - before, acc % 10);
+    fflush(stdout);
+}
+
+static void child(int layout, size_t n) {
+    if (layout == 0) {
+        run("list", n, [](size_t count) {
+            std::list<Book> books;
+            for (size_t i = 1; i <= count; i++) books.push_back(makeBook(i));
+            return books;
+        });
+    } else {
+        run("BookStore", n, [](size_t count) {
+            BookStore books;
+            for (size_t i = 1; i <= count; i++) books.add(makeBook(i));
+            return books;
+        });
+    }
+}
+
+int main() {
+    printf("%-10s %9s %14s %12s %6s\n", "layout", "books", "Mrows/s", "RSS KiB", "chk");
+    fflush(stdout);
+    const size_t sizes[] = {100000, 1000000};
+    for (size_t n : sizes) {
+        for (int layout = 0; layout < 2; layout++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                child(layout, n);
+                _exit(0);
+            }
+            waitpid(pid, nullptr, 0);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+// The regression suite: generates a catalogue (see CatalogueGenerator) and
+// times load, save, search, lookup, borrow/return and history display
+// through the library API. Prints one line per benchmark, as JSON (default)
+// or TSV, with throughput, per-call latency percentiles and the process's
+// peak RSS so far. Every option changes the catalogue or the call mix
+// deterministically, so two runs with the same options do the same work.
+//   bench_suite [--books N] [--members N] [--history N] [--reservations N]
+//               [--seed N] [--ops N] [--runs N] [--threads N] [--dir DIR] [--tsv]
+#include "CatalogueGenerator.hpp"
+#include "LibrarySystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+struct Options {
+    CatalogueSpec spec;
+    size_t ops = 20000;  // calls per API benchmark; searches are a tenth
+    size_t runs = 3;     // loads and saves
+    unsigned threads = 0; // loader threads, 0 = one per core
+    std::string dir = "/tmp/library_bench_suite";
+    bool tsv = false;
+};
+
+static long peakRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // KB on Linux
+}
+
+// Per-call latencies of one benchmark, in ns
+class Timings {
+private:
+    std::vector<double> samples;
+    double total = 0;
+
+public:
+    template <class F>
+    void time(F fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        samples.push_back(ns);
+        total += ns;
+    }
+    size_t count() const { return samples.size(); }
+    double seconds() const { return total / 1e9; }
+    double quantileUs(double q) {
+        if (samples.empty()) return 0;
+        std::sort(samples.begin(), samples.end());
+        size_t rank = static_cast<size_t>(q * samples.size());
+        return samples[std::min(rank, samples.size() - 1)] / 1e3;
+    }
+};
+
+class Report {
+private:
+    const Options& options;
+
+public:
+    explicit Report(const Options& options) : options(options) {
+        if (options.tsv)
+            printf("bench\tbooks\tmembers\thistory\treservations\tseed\tops\tseconds\tops_per_s\t"
+                   "p50_us\tp90_us\tp99_us\tmax_us\tpeak_rss_kb\n");
+    }
+
+    void line(const char* name, Timings& t) {
+        const CatalogueSpec& s = options.spec;
+        double rate = t.seconds() > 0 ? t.count() / t.seconds() : 0;
+        double p50 = t.quantileUs(0.5), p90 = t.quantileUs(0.9), p99 = t.quantileUs(0.99), max = t.quantileUs(1);
+        const char* format = options.tsv
+            ? "%s\t%zu\t%zu\t%zu\t%zu\t%llu\t%zu\t%.6f\t%.1f\t%.3f\t%.3f\t%.3f\t%.3f\t%ld\n"
+            : "{\"bench\":\"%s\",\"books\":%zu,\"members\":%zu,\"history\":%zu,\"reservations\":%zu,"
+              "\"seed\":%llu,\"ops\":%zu,\"seconds\":%.6f,\"ops_per_s\":%.1f,\"p50_us\":%.3f,"
+              "\"p90_us\":%.3f,\"p99_us\":%.3f,\"max_us\":%.3f,\"peak_rss_kb\":%ld}\n";
+        printf(format, name, s.books, s.members, s.history, s.reservations,
+               static_cast<unsigned long long>(s.seed), t.count(), t.seconds(), rate, p50, p90, p99, max,
+               peakRssKb());
+        fflush(stdout);
+    }
+};
+
+static bool parseOptions(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; i++) {
+        bool value = i + 1 < argc;
+        if (value && std::strcmp(argv[i], "--books") == 0) o.spec.books = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--members") == 0) o.spec.members = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--history") == 0) o.spec.history = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--reservations") == 0) o.spec.reservations = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--seed") == 0) o.spec.seed = std::stoull(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--ops") == 0) o.ops = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--runs") == 0) o.runs = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--threads") == 0) o.threads = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--dir") == 0) o.dir = argv[++i];
+        else if (std::strcmp(argv[i], "--tsv") == 0) o.tsv = true;
+        else return false;
+    }
+    return o.spec.books > 0 && o.spec.members > 0 && o.ops > 0 && o.runs > 0;
+}
+
+int main(int argc, char** argv) {
+    Options o;
+    if (!parseOptions(argc, argv, o)) {
+        fprintf(stderr,
+                "Usage: %s [--books N] [--members N] [--history N] [--reservations N]\n"
+                "       [--seed N] [--ops N] [--runs N] [--threads N] [--dir DIR] [--tsv]\n",
+                argv[0]);
+        return 1;
+    }
+    std::system(("rm -rf " + o.dir + " && mkdir -p " + o.dir).c_str());
+    if (!generateCatalogue(o.dir, o.spec)) {
+        fprintf(stderr, "Could not write the catalogue to %s\n", o.dir.c_str());
+        return 1;
+    }
+    Report report(o);
+    std::mt19937_64 rng(o.spec.seed);
+
+    // Each load but the last is saved and dropped; the saves rewrite the
+    // same catalogue, so every run loads identical files
+    std::unique_ptr<LibrarySystem> app;
+    Timings load;
+    for (size_t run = 0; run < o.runs; run++) {
+        app.reset();
+        load.time([&]() { app = std::make_unique<LibrarySystem>(DataFormat::Text, o.dir, o.threads); });
+    }
+    report.line("load", load);
+
+    // The first search builds the index
+    Timings index;
+    index.time([&]() { app->search("the", 0, 1); });
+    report.line("search_index_build", index);
+
+    std::vector<std::string> bookIds(o.ops), memberIds(o.ops);
+    for (size_t i = 0; i < o.ops; i++) {
+        bookIds[i] = std::to_string(1 + rng() % o.spec.books);
+        memberIds[i] = std::to_string(1 + rng() % o.spec.members);
+    }
+
+    Timings lookup;
+    Book book("", "", "", "", 0);
+    size_t found = 0;
+    for (const std::string& id : bookIds) lookup.time([&]() { found += app->findBook(id, book); });
+    report.line("lookup", lookup);
+
+    Timings search;
+    size_t hits = 0;
+    for (const std::string& query : sampleQueries(o.spec, std::max<size_t>(1, o.ops / 10)))
+        search.time([&]() { hits += app->search(query, 0, 50).size(); });
+    report.line("search", search);
+
+    // Books that were out stay out; each available one is lent and returned
+    Timings borrow, giveBack;
+    for (size_t i = 0; i < o.ops; i++) {
+        OpStatus status = OpStatus::Ok;
+        borrow.time([&]() { status = app->borrow(memberIds[i], bookIds[i]); });
+        if (status == OpStatus::Ok) giveBack.time([&]() { app->returnBook(memberIds[i], bookIds[i]); });
+    }
+    report.line("borrow", borrow);
+    report.line("return", giveBack);
+
+    // A screen of a member's history, newest page first
+    Timings history;
+    size_t entries = 0;
+    for (const std::string& member : memberIds) {
+        history.time([&]() {
+            size_t size = app->historySize(member);
+            size_t offset = size > 50 ? size - 50 : 0;
+            entries += app->historyOf(member, 0, std::numeric_limits<time_t>::max(), offset, 50).size();
+        });
+    }
+    report.line("history", history);
+
+    Timings save;
+    for (size_t run = 0; run < o.runs; run++) save.time([&]() { app->saveData(); });
+    report.line("save", save);
+
+    app.reset();
+    std::system(("rm -rf " + o.dir).c_str());
+    return found && hits && (entries || o.spec.history == 0) ? 0 : 1;
+}
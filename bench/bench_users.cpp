@@ -0,0 +1,134 @@
+// User ownership: one new per Person in a std::list<Person*> vs UserStore's
+// slab pools. Counts heap allocations and times building and tearing down
+// the user set, then does the same for a whole LibrarySystem text load.
+// Each measurement runs in its own child process.
+#include "LibrarySystem.hpp"
+#include "UserStore.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::atomic<size_t> allocations(0);
+
+// Out of line, like the library operators they replace: inlined, GCC pairs
+// the malloc() and free() inside them with the new and delete expressions
+// and reports a mismatch (-Wmismatched-new-delete)
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+static double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Generated up front so only the users' own allocations are counted
+struct Fields {
+    std::vector<std::string> ids, names, emails;
+    explicit Fields(size_t users) {
+        for (size_t i = 0; i < users; i++) {
+            ids.push_back(std::to_string(i));
+            names.push_back("Member " + std::to_string(i));
+            emails.push_back("m" + std::to_string(i) + "@mail.com");
+        }
+    }
+};
+
+static void report(const char* name, size_t users, size_t allocs, double buildMs, double teardownMs) {
+    printf("%-22s %12.2f %12.1f ms %12.1f ms\n", name, double(allocs) / users, buildMs, teardownMs);
+}
+
+static void runList(size_t users) {
+    Fields f(users);
+    size_t a0 = allocations;
+    auto t0 = std::chrono::steady_clock::now();
+    auto* list = new std::list<Person*>;
+    for (size_t i = 0; i < users; i++) {
+        if (i % 100 == 0) list->push_back(new Librarian(f.ids[i], f.names[i], f.emails[i]));
+        else list->push_back(new Member(f.ids[i], f.names[i], f.emails[i]));
+    }
+    double buildMs = msSince(t0);
+    size_t allocs = allocations - a0;
+    t0 = std::chrono::steady_clock::now();
+    for (Person* p : *list) {
+        if (Member* m = asMember(p)) delete m;
+        else delete asLibrarian(p);
+    }
+    delete list;
+    report("new + list<Person*>", users, allocs, buildMs, msSince(t0));
+}
+
+static void runStore(size_t users) {
+    Fields f(users);
+    size_t a0 = allocations;
+    auto t0 = std::chrono::steady_clock::now();
+    auto* store = new UserStore;
+    for (size_t i = 0; i < users; i++) {
+        if (i % 100 == 0) store->add(store->newLibrarian(f.ids[i], f.names[i], f.emails[i]));
+        else store->add(store->newMember(f.ids[i], f.names[i], f.emails[i]));
+    }
+    double buildMs = msSince(t0);
+    size_t allocs = allocations - a0;
+    t0 = std::chrono::steady_clock::now();
+    delete store;
+    report("UserStore (slabs)", users, allocs, buildMs, msSince(t0));
+}
+
+static void writeTextData(const std::string& dir, size_t members) {
+    std::ofstream b(dir + "/books.txt");
+    for (size_t i = 1; i <= 1000; i++) b << i << "|Synthetic Title " << i << "|Author|Fiction|0|0||\n";
+    std::ofstream u(dir + "/users.txt");
+    u << "Librarian|admin|Admin|admin@library.com\n";
+    for (size_t i = 1; i <= members; i++) u << "Member|" << i << "|Member " << i << "|m" << i << "@mail.com|\n";
+}
+
+static void runSystem(const std::string& dir, size_t members) {
+    size_t a0 = allocations;
+    auto t0 = std::chrono::steady_clock::now();
+    auto app = std::make_unique<LibrarySystem>(DataFormat::Text, dir, 1);
+    double loadMs = msSince(t0);
+    size_t allocs = allocations - a0;
+    t0 = std::chrono::steady_clock::now();
+    app.reset(); // includes the checkpoint written on exit
+    report("LibrarySystem load", members, allocs, loadMs, msSince(t0));
+}
+
+template <class F>
+static void inChild(F fn) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        fn();
+        fflush(stdout);
+        _exit(0);
+    }
+    waitpid(pid, nullptr, 0);
+}
+
+int main(int argc, char** argv) {
+    size_t users = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    printf("users: %zu\n", users);
+    printf("%-22s %12s %15s %15s\n", "layout", "allocs/user", "build", "teardown");
+    fflush(stdout);
+    inChild([&]() { runList(users); });
+    inChild([&]() { runStore(users); });
+
+    std::string dir = "/tmp/library_bench_users";
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    writeTextData(dir, users);
+    inChild([&]() { std::make_unique<LibrarySystem>(DataFormat::Text, dir, 1).reset(); }); // add checkpoint lines
+    inChild([&]() { runSystem(dir, users); });
+    std::system(("rm -rf " + dir).c_str());
+    return 0;
+}
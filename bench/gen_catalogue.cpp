@@ -0,0 +1,44 @@
+// Writes a synthetic books.txt and users.txt for loading with the library
+// or the benchmarks. The same options always give the same files.
+//   gen_catalogue [--books N] [--members N] [--history N] [--reservations N]
+//                 [--borrowed SHARE] [--reserved SHARE] [--seed N] DIR
+#include "CatalogueGenerator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+int main(int argc, char** argv) {
+    CatalogueSpec spec;
+    std::string dir;
+    bool usage = false;
+    for (int i = 1; i < argc && !usage; i++) {
+        bool value = i + 1 < argc;
+        if (value && std::strcmp(argv[i], "--books") == 0) spec.books = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--members") == 0) spec.members = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--history") == 0) spec.history = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--reservations") == 0) spec.reservations = std::stoul(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--borrowed") == 0) spec.borrowedShare = std::stod(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--reserved") == 0) spec.reservedShare = std::stod(argv[++i]);
+        else if (value && std::strcmp(argv[i], "--seed") == 0) spec.seed = std::stoull(argv[++i]);
+        else if (argv[i][0] != '-' && dir.empty()) dir = argv[i];
+        else usage = true;
+    }
+    if (usage || dir.empty()) {
+        fprintf(stderr,
+                "Usage: %s [--books N] [--members N] [--history N] [--reservations N]\n"
+                "       [--borrowed SHARE] [--reserved SHARE] [--seed N] DIR\n",
+                argv[0]);
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (!generateCatalogue(dir, spec)) {
+        fprintf(stderr, "Could not write %s/books.txt and %s/users.txt\n", dir.c_str(), dir.c_str());
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("%zu books, %zu members, %zu history entries each, queues of %zu, seed %llu: %.2f s\n", spec.books,
+           spec.members, spec.history, spec.reservations, static_cast<unsigned long long>(spec.seed), seconds);
+    return 0;
+}
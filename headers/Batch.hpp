@@ -0,0 +1,46 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+// One row of a bulk operation, as read from an import feed or scan file
+enum class BatchOpKind { AddBook, Borrow, Return };
+
+struct BatchOp {
+    BatchOpKind kind;
+    std::string bookId;   // AddBook: empty = assign the next free numeric ID
+    std::string memberId; // Return: optional, checked against the borrower
+    std::string title;    // AddBook only
+    std::string author;
+    std::string genre;
+    size_t line = 0;      // source line, for error messages
+};
+
+struct BatchError {
+    size_t line; // the item's source line, or its 1-based position if it has none
+    std::string reason;
+};
+
+// applyBatch() either applies every item or none of them
+struct BatchResult {
+    bool applied;
+    size_t added, borrowed, returned;
+    std::vector<BatchError> errors; // empty when applied
+};
+
+// Parses batch rows, one per line, fields separated by delim:
+//   add,<book id or empty>,<title>,<author>,<genre>
+//   borrow,<member id>,<book id>
+//   return,<book id>[,<member id>]
+// Fields may be double-quoted ("" is a literal quote) to contain the
+// delimiter. Blank lines and lines starting with '#' are skipped.
+void parseBatch(std::string_view text, char delim, std::vector<BatchOp>& ops, std::vector<BatchError>& errors);
+
+// Reads a .csv or .tsv batch file (tab-separated if the name ends in .tsv
+// or the first line contains a tab); false if it cannot be read
+bool readBatchFile(const std::string& path, std::vector<BatchOp>& ops, std::vector<BatchError>& errors);
+
+#endif
@@ -2,43 +2,72 @@
 #define BOOK_HPP
 
 #include <string>
-#include <queue>
+#include <string_view>
+#include "ReservationQueue.hpp"
+#include "StringPool.hpp"
 #include <ctime>
 
+// A book's fields without its reservation queue: plain data, so catalogue
+// snapshots can copy it freely. Getters view the same pool strings.
+struct BookRecord {
+    StringPool::Handle id;
+    StringPool::Handle title;
+    StringPool::Handle author;
+    StringPool::Handle genre;
+    StringPool::Handle borrowedBy; // 0 (empty) when not borrowed
+    bool isBorrowed;
+    time_t dueDate;
+
+    std::string_view getId() const { return StringPool::global().view(id); }
+    std::string_view getTitle() const { return StringPool::global().view(title); }
+    std::string_view getAuthor() const { return StringPool::global().view(author); }
+    std::string_view getGenre() const { return StringPool::global().view(genre); }
+    std::string_view getBorrowedById() const { return StringPool::global().view(borrowedBy); }
+};
+
+// Text fields are StringPool handles: a book is ~48 bytes however long its
+// strings are, and books sharing an author or genre share its characters.
+// Getters return views into the pool, valid for the life of the process.
 class Book {
 private:
-    std::string id;
-    std::string title;
-    std::string author;
-    std::string genre;
+    StringPool::Handle id;
+    StringPool::Handle title;
+    StringPool::Handle author;
+    StringPool::Handle genre;
+    StringPool::Handle borrowedByMemberId; // 0 (empty) when not borrowed
     bool isBorrowed;
     time_t dueDate;
-    std::string borrowedByMemberId;
-    std::queue<std::string> reservationQueue; // 
+    ReservationQueue reservationQueue; // FIFO, front = next in line
 
 public:
-    Book(std::string id, std::string title, std::string author, std::string genre, time_t dueDate);
+    Book(std::string_view id, std::string_view title, std::string_view author, std::string_view genre, time_t dueDate);
+    explicit Book(const BookRecord& record); // with no reservations
     
     // Getters
-    std::string getId() const;
-    std::string getTitle() const;
-    std::string getAuthor() const;
-    std::string getGenre() const;
+    std::string_view getId() const;
+    std::string_view getTitle() const;
+    std::string_view getAuthor() const;
+    std::string_view getGenre() const;
     bool getIsBorrowed() const;
     time_t getDueDate() const;
-    std::string getBorrowedById() const;
+    std::string_view getBorrowedById() const;
+    const ReservationQueue& getReservations() const;
+    BookRecord record() const;
 
     // Setters and Operations
-    void borrowBook(std::string memberId, int daysToBorrow, time_t due = 0);
+    void borrowBook(std::string_view memberId, int daysToBorrow, time_t due = 0);
     void returnBook();
-    void addReservation(std::string memberId);
+    // Safe to call concurrently with other reservations; everything else on a
+    // Book, including the two calls below, needs the book's lock
+    void addReservation(std::string_view memberId);
     std::string processNextReservation(); // Returns member ID of next in line
+    bool removeReservation(std::string_view memberId);
     bool hasReservations() const;
     
     // Formatting helpers
     std::string toString() const; // For display
     std::string toFileString() const; // For text file storage
-    void loadReservationsFromString(const std::string& data); // Helper to load queue
+    void loadReservationsFromString(std::string_view data); // Helper to load queue
 };
 
 #endif
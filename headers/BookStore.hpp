@@ -0,0 +1,60 @@
+#ifndef BOOKSTORE_HPP
+#define BOOKSTORE_HPP
+
+#include "Book.hpp"
+#include <vector>
+#include <cstdint>
+
+// Stable integer reference to a book slot; replaces long-lived Book* so
+// the underlying array is free to grow
+typedef uint32_t BookHandle;
+const BookHandle INVALID_BOOK = UINT32_MAX;
+
+// Contiguous catalogue storage. Books live in one array indexed by handle;
+// removed slots are recycled, so scans are a linear sweep over live slots.
+class BookStore {
+private:
+    std::vector<Book> records;
+    std::vector<uint8_t> live;
+    std::vector<BookHandle> freeSlots;
+    size_t count;
+
+public:
+    class const_iterator {
+    private:
+        const BookStore* store;
+        BookHandle slot;
+        void skipDead() {
+            while (slot < store->records.size() && !store->live[slot]) slot++;
+        }
+    public:
+        const_iterator(const BookStore* store, BookHandle slot) : store(store), slot(slot) { skipDead(); }
+        const Book& operator*() const { return store->records[slot]; }
+        const Book* operator->() const { return &store->records[slot]; }
+        BookHandle handle() const { return slot; }
+        const_iterator& operator++() { slot++; skipDead(); return *this; }
+        bool operator!=(const const_iterator& other) const { return slot != other.slot; }
+        bool operator==(const const_iterator& other) const { return slot == other.slot; }
+    };
+
+    BookStore();
+
+    BookHandle add(Book book);
+    void remove(BookHandle handle);
+    void clear();
+    void reserve(size_t n);
+
+    // Pointers/references are invalidated by the next add()
+    Book& get(BookHandle handle) { return records[handle]; }
+    const Book& get(BookHandle handle) const { return records[handle]; }
+    bool isLive(BookHandle handle) const { return handle < live.size() && live[handle]; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t slotCount() const { return records.size(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, static_cast<BookHandle>(records.size())); }
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef CATALOGUEGENERATOR_HPP
+#define CATALOGUEGENERATOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+
+// Shape of a synthetic catalogue for benchmarks. The same spec always
+// produces the same files, byte for byte: nothing depends on the clock,
+// the platform's random distributions or the locale.
+struct CatalogueSpec {
+    size_t books = 100000;
+    size_t members = 10000;
+    size_t history = 20;        // entries per member, oldest first
+    size_t reservations = 2;    // queue length on each reserved book
+    double borrowedShare = 0.2; // of the books
+    double reservedShare = 0.1; // of the borrowed books
+    uint64_t seed = 1;
+    time_t epoch = 1767225600;  // 2026-01-01; due dates fall within two weeks of it
+};
+
+// Writes dir/books.txt and dir/users.txt in the loader's format; false if
+// either cannot be written
+bool generateCatalogue(const std::string& dir, const CatalogueSpec& spec);
+
+// n search queries from the catalogue's vocabulary: title words, author
+// names, genres and two-word phrases
+std::vector<std::string> sampleQueries(const CatalogueSpec& spec, size_t n);
+
+#endif
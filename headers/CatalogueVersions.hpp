@@ -0,0 +1,83 @@
+#ifndef CATALOGUEVERSIONS_HPP
+#define CATALOGUEVERSIONS_HPP
+
+#include "BookStore.hpp"
+#include "Person.hpp"
+#include "HashIndex.hpp"
+#include "StringPool.hpp"
+#include "VersionedTable.hpp"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// An account's details as plain data for catalogue snapshots
+struct UserRecord {
+    StringPool::Handle id;
+    StringPool::Handle name;
+    StringPool::Handle email;
+    Role role;
+
+    std::string_view getId() const { return StringPool::global().view(id); }
+    std::string_view getName() const { return StringPool::global().view(name); }
+    std::string_view getEmail() const { return StringPool::global().view(email); }
+};
+
+// Every book and account as of one commit. Scanning it takes no library
+// locks and it never changes; holding it only keeps that version's rows
+// alive. Release it before the LibrarySystem is destroyed.
+class CatalogueSnapshot {
+private:
+    friend class CatalogueVersions;
+    struct State {
+        VersionedTable<BookRecord>::Pin books;
+        VersionedTable<UserRecord>::Pin users;
+    };
+    std::shared_ptr<const State> state;
+
+public:
+    size_t bookCount() const { return state->books->size(); }
+    size_t userCount() const { return state->users->size(); }
+    // fn(handle, record) in handle order until it returns false
+    template <typename F>
+    void forEachBook(F fn) const {
+        state->books->forEach([&](uint32_t slot, const BookRecord& r) { return fn(static_cast<BookHandle>(slot), r); });
+    }
+    const BookRecord* findBook(BookHandle handle) const { return state->books->find(handle); }
+    // fn(record) until it returns false; accounts added later may reuse an
+    // earlier position
+    template <typename F>
+    void forEachUser(F fn) const {
+        state->users->forEach([&](uint32_t, const UserRecord& r) { return fn(r); });
+    }
+};
+
+// The write side: copies of the book and account rows, published together
+// so a snapshot never shows one half of a commit. Writers are serialized by
+// the owner; pin() may run on any thread at any time and is O(1).
+class CatalogueVersions {
+private:
+    VersionedTable<BookRecord> books; // by book handle
+    VersionedTable<UserRecord> users; // by slot in userSlots
+    HashIndex<uint32_t> userSlots;
+    std::vector<uint32_t> freeUserSlots;
+    uint32_t userSlotCount;
+    // Atomic access only. Declared last so it is released before the tables.
+    std::shared_ptr<const CatalogueSnapshot::State> published;
+
+public:
+    CatalogueVersions();
+
+    void putBook(BookHandle handle, const Book& book);
+    void eraseBook(BookHandle handle);
+    void putUser(const Person& user);
+    void eraseUser(const std::string& id);
+    void clear();
+
+    // Makes the rows as they are now the version pin() returns
+    void publish();
+    CatalogueSnapshot pin() const;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef DUEINDEX_HPP
+#define DUEINDEX_HPP
+
+#include "BookStore.hpp"
+#include <vector>
+#include <cstdint>
+#include <ctime>
+
+struct DueLoan {
+    time_t due;
+    BookHandle book;
+};
+
+// Active loans ordered by due date: a binary min-heap that also records
+// each book's position in it, so a return removes its loan in O(log n).
+// Loans due before a given time are collected by walking only the part of
+// the heap above that time, O(k) for k loans, then sorted.
+class DueIndex {
+private:
+    static constexpr uint32_t NOT_QUEUED = UINT32_MAX;
+    std::vector<DueLoan> heap;
+    std::vector<uint32_t> position; // by book handle
+
+    void place(size_t i, DueLoan loan);
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+
+public:
+    // Replaces the book's previous entry, if any
+    void add(BookHandle book, time_t due);
+    void remove(BookHandle book); // no-op if the book has no entry
+    bool contains(BookHandle book) const;
+    size_t size() const { return heap.size(); }
+    bool empty() const { return heap.empty(); }
+    const DueLoan& earliest() const { return heap.front(); } // not empty
+
+    // Loans with due < asOf, earliest first (ties by handle)
+    std::vector<DueLoan> dueBefore(time_t asOf) const;
+};
+
+#endif
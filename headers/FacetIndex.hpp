@@ -0,0 +1,89 @@
+#ifndef FACETINDEX_HPP
+#define FACETINDEX_HPP
+
+#include "BookStore.hpp"
+#include "HashIndex.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// The multi-valued fields books can be browsed by. Genres are split on
+// commas, so "fiction, gods" is in "fiction" and in "gods". Authors are
+// split on semicolons, since a comma is part of names like
+// "Tolkien, J.R.R."; co-authors are written "Pratchett; Gaiman".
+enum class Facet : uint8_t { Genre, Author };
+
+struct FacetCount {
+    std::string value; // as first seen, trimmed
+    size_t books;
+    size_t available;
+};
+
+// Books by normalized genre and author value (trimmed, lower-case, inner
+// whitespace collapsed), with a running count of books and of available
+// books per value. add()/remove() keep the lists; setAvailable() must be
+// called on every loan state change so the counts stay exact.
+class FacetIndex {
+private:
+    struct Value {
+        std::string key; // normalized
+        std::string label;
+        std::vector<BookHandle> books; // sorted
+        size_t available;
+    };
+    // A value whose last book goes is dropped from ids and its slot reused
+    struct Field {
+        HashIndex<uint32_t> ids; // normalized value -> index in values
+        std::vector<Value> values;
+        std::vector<uint32_t> freeIds;
+    };
+
+    // Each book's value IDs, genres then authors, so loan changes and
+    // removals skip the string work. Slots re-added after a removal append
+    // a fresh run; the pool is compacted once most of it is dead.
+    struct BookValues {
+        uint32_t first; // in valuePool
+        uint8_t genres;
+        uint8_t authors;
+    };
+
+    const BookStore& store;
+    Field fields[2];
+    std::vector<BookValues> byBook; // by handle
+    std::vector<uint32_t> valuePool;
+    size_t deadValues;              // pool entries no book points at
+    std::string scratch;            // normalization buffer
+    std::vector<uint32_t> bookIds;  // one book's value IDs, deduplicated
+
+    Field& field(Facet facet) { return fields[static_cast<int>(facet)]; }
+    const Field& field(Facet facet) const { return fields[static_cast<int>(facet)]; }
+    static std::string_view text(const Book& book, Facet facet);
+    // Fills bookIds with the IDs of the book's values, creating missing ones
+    void collect(const Book& book, Facet facet);
+    // Calls fn(value) for each of the book's values
+    template <typename F>
+    void forEachValue(BookHandle handle, F fn);
+    void compactPool();
+
+public:
+    explicit FacetIndex(const BookStore& store);
+
+    void add(BookHandle handle);    // call after the book is stored
+    void remove(BookHandle handle); // call before the book leaves the store
+    // Call after the book is borrowed (false) or returned (true)
+    void setAvailable(BookHandle handle, bool available);
+    void clear();
+
+    // Trims and case-folds one value; out is empty if nothing is left
+    static void normalize(std::string_view raw, std::string& out);
+
+    // Books with value in the facet, in handle order; nullptr if none
+    const std::vector<BookHandle>* books(Facet facet, std::string_view value) const;
+    bool count(Facet facet, std::string_view value, FacetCount& out) const;
+    // Every value with at least one book, most books first
+    std::vector<FacetCount> counts(Facet facet) const;
+};
+
+#endif
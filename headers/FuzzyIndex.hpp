@@ -0,0 +1,69 @@
+#ifndef FUZZYINDEX_HPP
+#define FUZZYINDEX_HPP
+
+#include "BookStore.hpp"
+#include "HashIndex.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+struct FuzzyResult {
+    BookHandle book;
+    float score; // 0..1, 1 = every query word found exactly
+};
+
+// Typo-tolerant matching of title and author words. Each distinct word is
+// stored once and indexed by its trigrams (padded with '$' at both ends).
+// A query word's candidates are the words sharing enough trigrams to be
+// within its edit budget; they are verified with a bit-parallel
+// Levenshtein distance that gives up as soon as the budget is exceeded.
+class FuzzyIndex {
+private:
+    struct Word {
+        std::string text;
+        std::vector<BookHandle> books; // sorted
+    };
+
+    const BookStore& store;
+    HashIndex<uint32_t> ids;   // word -> index in words
+    // A word whose last book is removed leaves ids and its trigram lists,
+    // and its slot goes to the next new word
+    std::vector<Word> words;
+    std::vector<uint32_t> freeIds;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams; // -> word IDs, unordered
+    std::vector<std::string> scratch; // one book's words
+
+    // Lower-case title and author words, deduplicated; numbers are skipped
+    static void collectWords(const Book& book, std::vector<std::string>& out);
+
+public:
+    // Longer words are not indexed: the distance works on one 64-bit word
+    static constexpr size_t MAX_WORD = 64;
+
+    explicit FuzzyIndex(const BookStore& store);
+
+    void add(BookHandle handle);    // call after the book is stored
+    void remove(BookHandle handle); // call before the book leaves the store
+    void clear();
+
+    size_t wordCount() const;
+
+    // Edits allowed for a query word: none up to 2 letters, one up to 5,
+    // two beyond
+    static int maxEdits(size_t length);
+    // Levenshtein distance of a and b, or limit + 1 once it is known to
+    // exceed limit. a must be at most MAX_WORD bytes.
+    static int distance(std::string_view a, std::string_view b, int limit);
+
+    // The k books whose title and author words best match the query words,
+    // best first. A book's score is the mean over query words of
+    // 1 - edits / length for its closest word (0 for none). Safe to call
+    // from several threads at once: the per-book scratch is per thread and
+    // reused across calls.
+    std::vector<FuzzyResult> search(const std::string& query, size_t k) const;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef HASHINDEX_HPP
+#define HASHINDEX_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// FNV-1a; StringPool also uses it to pick shards and slots
+inline uint32_t hashId(const char* data, size_t length) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Open-addressing (linear probing) hash table keyed on string IDs.
+// Used as the primary-key index for books and users.
+template <typename V>
+class HashIndex {
+private:
+    enum SlotState : uint8_t { EMPTY, USED, DELETED };
+
+    struct Slot {
+        std::string key;
+        V value;
+        uint32_t hash;
+        SlotState state;
+        Slot() : value(), hash(0), state(EMPTY) {}
+    };
+
+    std::vector<Slot> slots;
+    size_t count;
+    size_t tombstones;
+
+    static uint32_t hashKey(std::string_view key) {
+        return hashId(key.data(), key.size());
+    }
+
+    size_t mask() const { return slots.size() - 1; }
+
+    // Returns the slot holding key, or slots.size() if absent
+    size_t locate(std::string_view key, uint32_t h) const {
+        if (slots.empty()) return 0;
+        size_t i = h & mask();
+        while (true) {
+            const Slot& s = slots[i];
+            if (s.state == EMPTY) return slots.size();
+            if (s.state == USED && s.hash == h && s.key == key) return i;
+            i = (i + 1) & mask();
+        }
+    }
+
+    void rehash(size_t newCapacity) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.resize(newCapacity);
+        count = 0;
+        tombstones = 0;
+        for (auto& s : old) {
+            if (s.state == USED) place(std::move(s.key), std::move(s.value), s.hash);
+        }
+    }
+
+    void place(std::string&& key, V value, uint32_t h) {
+        size_t i = h & mask();
+        while (slots[i].state == USED) i = (i + 1) & mask();
+        if (slots[i].state == DELETED) tombstones--;
+        slots[i].key = std::move(key);
+        slots[i].value = std::move(value);
+        slots[i].hash = h;
+        slots[i].state = USED;
+        count++;
+    }
+
+    void grow() {
+        // Keep (live + tombstones) under 70% of capacity
+        if (slots.empty()) {
+            rehash(16);
+        } else if ((count + tombstones + 1) * 10 > slots.size() * 7) {
+            rehash(count * 10 >= slots.size() * 5 ? slots.size() * 2 : slots.size());
+        }
+    }
+
+public:
+    HashIndex() : count(0), tombstones(0) {}
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void reserve(size_t n) {
+        size_t cap = 16;
+        while (cap * 7 < n * 10) cap *= 2;
+        if (cap > slots.size()) rehash(cap);
+    }
+
+    void clear() {
+        slots.clear();
+        count = 0;
+        tombstones = 0;
+    }
+
+    // Inserts or overwrites the value stored under key
+    void insert(std::string_view key, const V& value) {
+        uint32_t h = hashKey(key);
+        size_t i = locate(key, h);
+        if (i < slots.size()) {
+            slots[i].value = value;
+            return;
+        }
+        grow();
+        place(std::string(key), value, h);
+    }
+
+    // Returns a pointer to the stored value, or nullptr if key is absent
+    const V* find(std::string_view key) const {
+        size_t i = locate(key, hashKey(key));
+        return i < slots.size() ? &slots[i].value : nullptr;
+    }
+
+    V* find(std::string_view key) {
+        size_t i = locate(key, hashKey(key));
+        return i < slots.size() ? &slots[i].value : nullptr;
+    }
+
+    bool contains(std::string_view key) const {
+        return find(key) != nullptr;
+    }
+
+    bool erase(std::string_view key) {
+        size_t i = locate(key, hashKey(key));
+        if (i >= slots.size()) return false;
+        slots[i].state = DELETED;
+        slots[i].key.clear();
+        slots[i].value = V();
+        count--;
+        tombstones++;
+        return true;
+    }
+};
+
+#endif
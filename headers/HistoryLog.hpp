@@ -0,0 +1,100 @@
+#ifndef HISTORYLOG_HPP
+#define HISTORYLOG_HPP
+
+#include "StringPool.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+
+enum class HistoryAction : uint8_t { Borrowed, Returned };
+
+std::string_view historyActionName(HistoryAction action);
+bool parseHistoryAction(std::string_view name, HistoryAction& action);
+
+struct HistoryEntry {
+    time_t time;
+    HistoryAction action;
+    std::string_view title; // interned, valid for the life of the process
+};
+
+// Borrowing history of one member, stored column by column (13 bytes per
+// entry) and kept sorted by time, so range() is two binary searches. An
+// entry older than the last (the clock went backwards) is inserted in
+// place, after any with the same time. Titles are StringPool handles rather
+// than book handles: the history outlives books that are later removed.
+class HistoryLog {
+private:
+    std::vector<int64_t> times;
+    std::vector<StringPool::Handle> titles;
+    std::vector<HistoryAction> actions;
+    // Entries from old data files that do not parse, kept verbatim so a
+    // save writes them back; they are not listed
+    std::vector<StringPool::Handle> unparsed;
+
+public:
+    // Entries [first, last) of a log, iterable without copying the log
+    class View {
+    private:
+        const HistoryLog* log;
+        size_t first, last;
+
+    public:
+        class const_iterator {
+        private:
+            const HistoryLog* log;
+            size_t i;
+
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef HistoryEntry value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const HistoryEntry* pointer;
+            typedef HistoryEntry reference;
+
+            const_iterator(const HistoryLog* log, size_t i) : log(log), i(i) {}
+            HistoryEntry operator*() const { return log->at(i); }
+            const_iterator& operator++() {
+                i++;
+                return *this;
+            }
+            bool operator==(const const_iterator& o) const { return i == o.i; }
+            bool operator!=(const const_iterator& o) const { return i != o.i; }
+        };
+
+        View(const HistoryLog* log, size_t first, size_t last) : log(log), first(first), last(last) {}
+        const_iterator begin() const { return const_iterator(log, first); }
+        const_iterator end() const { return const_iterator(log, last); }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+        size_t offset() const { return first; } // position of the first entry in the log
+        // Up to count entries starting at offset within this view
+        View page(size_t offset, size_t count) const;
+    };
+
+    void append(time_t time, HistoryAction action, std::string_view title);
+    // Parses and appends a "timestamp|action|title" entry; false if malformed,
+    // in which case the text is kept as an unparsed entry
+    bool appendEntry(std::string_view entry);
+    void clear();
+
+    size_t size() const { return times.size(); }
+    bool empty() const { return times.empty(); }
+    HistoryEntry at(size_t i) const;
+
+    View all() const { return View(this, 0, size()); }
+    // Entries with from <= time < to
+    View range(time_t from, time_t to) const;
+
+    size_t unparsedCount() const { return unparsed.size(); }
+    std::string_view unparsedEntry(size_t i) const { return StringPool::global().view(unparsed[i]); }
+
+    // Appends "timestamp|action|title" entries separated by ',', then the
+    // unparsed entries as they were read
+    void writeTo(std::string& out) const;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef IDALLOCATOR_HPP
+#define IDALLOCATOR_HPP
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Hands out the lowest numeric ID not in use. A bit per ID up to the
+// highest one seen, plus a bit per 64-ID word that has no free bit, so a
+// search for a gap skips full stretches 4096 IDs at a time, and starts
+// from the lowest word that can hold one. Only canonical decimal IDs
+// ("12", not "012") are tracked; others never equal a generated ID.
+class IdAllocator {
+private:
+    std::vector<uint64_t> used; // bit n % 64 of word n / 64: ID n is taken
+    std::vector<uint64_t> full; // bit w % 64 of word w / 64: used[w] is all ones
+    size_t lowest;              // no free bit in the used words below this
+    uint64_t overflow;          // next ID handed out once MAX_TRACKED is reached
+
+    void grow(size_t words);
+    void set(uint64_t n);
+
+public:
+    // IDs above this are not tracked (8 MB of bitmap); the owner has to
+    // check IDs past it against its own index
+    static constexpr uint64_t MAX_TRACKED = (uint64_t(1) << 26) - 1;
+
+    IdAllocator();
+
+    void clear();
+    // Marks id as taken / free; no-op for IDs that are not tracked
+    void take(std::string_view id);
+    void release(std::string_view id);
+    // The lowest free ID, now marked as taken. Amortized O(1): the search
+    // resumes where the last one stopped unless an ID below was released.
+    uint64_t allocate();
+};
+
+#endif
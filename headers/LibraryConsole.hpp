@@ -0,0 +1,52 @@
+#ifndef LIBRARYCONSOLE_HPP
+#define LIBRARYCONSOLE_HPP
+
+#include "LibrarySystem.hpp"
+#include "TableWriter.hpp"
+#include <string>
+
+// The interactive menus. All terminal I/O lives here; every action is a
+// call into the LibrarySystem API.
+class LibraryConsole {
+private:
+    LibrarySystem& library;
+
+    void librarianMenu(const UserInfo& lib);
+    void memberMenu(const UserInfo& mem);
+    void guestMenu();
+
+    void addBook();
+    void removeBook();
+    void displayAllBooks();
+    void registerUser();
+    void removeUser();
+    void displayAllUsers();
+    void displayOverdue();
+    void displayMetrics();
+    bool searchBooks();
+    void browseGenres();
+    void borrowBook(const UserInfo& mem);
+    void returnBook(const UserInfo& mem);
+    void displayBorrowedBooks(const UserInfo& mem);
+    void displayHistory(const UserInfo& mem);
+
+public:
+    explicit LibraryConsole(LibrarySystem& library);
+
+    // One pass through the login screen; false once the user chooses to exit
+    bool run();
+
+    // Non-interactive listings for scripts: books matching query (all of
+    // them if it is empty) or every account, skipping offset rows
+    void printBooks(const std::string& query, TableFormat format, size_t offset, size_t limit);
+    void printUsers(TableFormat format, size_t offset, size_t limit);
+    // The limit closest matches for a query that may contain typos, scored
+    void printFuzzy(const std::string& query, TableFormat format, size_t limit);
+    // Books with a genre or author value, or the per-value counts
+    void printBrowse(Facet facet, const std::string& value, TableFormat format, size_t offset, size_t limit);
+    void printFacets(Facet facet, TableFormat format, size_t offset, size_t limit);
+    // Loans due before asOf with their fines; Text adds a totals line
+    void printOverdue(time_t asOf, TableFormat format);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef LIBRARYSERVER_HPP
+#define LIBRARYSERVER_HPP
+
+#include "LibrarySystem.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Serves LibrarySystem to many clients over a Unix domain socket, one thread
+// per connection. The protocol is line based; every request gets a status
+// line "OK <n>" followed by n data lines, or "ERR <reason>":
+//   SEARCH <query>          books as id|title|author|genre|status|due
+//   LOANS <member>          the member's borrowed books, same format
+//   HISTORY <member> [from to [offset]]
+//                           history entries as time|action|title, oldest first
+//   BORROW <member> <book>
+//   RESERVE <member> <book>
+//   RETURN <member> <book>
+//   METRICS                 latencies and counters, Prometheus text format
+//   QUIT
+class LibraryServer {
+private:
+    LibrarySystem& library;
+    std::string socketPath;
+    int listenFd;
+    std::atomic<bool> stopping;
+    std::thread acceptor;
+
+    // Session threads are detached; stop() shuts their sockets down to wake
+    // blocked reads and waits until the list is empty
+    std::mutex sessionsLock;
+    std::condition_variable sessionsDone;
+    std::vector<int> sessionFds;
+
+    void acceptLoop();
+    void serveSession(int fd);
+
+public:
+    LibraryServer(LibrarySystem& library, const std::string& socketPath);
+    ~LibraryServer();
+    LibraryServer(const LibraryServer&) = delete;
+    LibraryServer& operator=(const LibraryServer&) = delete;
+
+    bool start();
+    void stop();
+
+    // Runs one request line and returns the full response
+    std::string handle(const std::string& request);
+};
+
+#endif
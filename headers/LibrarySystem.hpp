@@ -2,49 +2,246 @@
 #define LIBRARYSYSTEM_HPP
 
 #include "Book.hpp"
+#include "BookStore.hpp"
 #include "Person.hpp"
-#include <list>
+#include "UserStore.hpp"
+#include "HashIndex.hpp"
+#include "SearchIndex.hpp"
+#include "SearchCache.hpp"
+#include "OperationLog.hpp"
+#include "Batch.hpp"
+#include "DueIndex.hpp"
+#include "FacetIndex.hpp"
+#include "FuzzyIndex.hpp"
+#include "IdAllocator.hpp"
+#include "CatalogueVersions.hpp"
 #include <vector>
+#include <string>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+// Text keeps the pipe-delimited files as the primary store; Binary loads and
+// saves a mapped snapshot and only imports the text files when none exists
+enum class DataFormat { Text, Binary };
+
+// ReadOnly loads the data and the operation log but never writes either:
+// no log is opened and nothing is saved on exit, so changes stay in memory
+enum class AccessMode { ReadWrite, ReadOnly };
+
+// Outcome of the library operations
+enum class OpStatus { Ok, NoSuchBook, NoSuchMember, NoSuchUser, Unavailable, NotBorrower, DuplicateId, NotAllowed };
+
+// Late-return charge, per whole day past the due date
+struct Fine {
+    bool overdue;
+    int daysOverdue;
+    double amount; // RM
+};
+
+struct ReturnResult {
+    OpStatus status;
+    Fine fine; // zero unless status is Ok
+};
+
+// A loan past its due date, with the fine it has run up so far
+struct OverdueLoan {
+    std::string bookId;
+    std::string title;
+    std::string memberId;
+    time_t dueDate;
+    Fine fine;
+};
+
+struct OverdueReport {
+    time_t asOf;
+    std::vector<OverdueLoan> loans; // earliest due first
+    double totalFines;
+};
+
+// A book close to a misspelt query; score is 0..1, 1 for an exact match
+struct FuzzyMatch {
+    Book book;
+    double score;
+};
+
+// A copy of an account's details, safe to keep after the call
+struct UserInfo {
+    std::string id;
+    std::string name;
+    std::string email;
+    Role role;
+};
 
 class LibrarySystem {
 private:
-    std::list<Book> books;
-    std::list<Person*> users;
+    BookStore books;
+    UserStore users;
+
+    // Primary-key indexes, kept in sync with the stores above
+    HashIndex<BookHandle> bookIndex;
+    HashIndex<Person*> userIndex;
+    IdAllocator bookIds; // numeric book IDs in use, rebuilt by loadData()
+    SearchIndex searchIndex;
+    bool searchIndexReady; // built on first search to keep startup cheap
+    SearchCache searchCache; // filled by searches once the index is ready
+    FacetIndex facets;
+    bool facetsReady;      // likewise, on first browse
+    FuzzyIndex fuzzyIndex;
+    bool fuzzyReady;       // and on first fuzzy search
+    HashIndex<std::vector<BookHandle>> loansByMember;
+    // Published copies of the books and accounts for lock-free snapshots,
+    // built on first use. Written under the exclusive stateLock or, for
+    // loan changes, under loansLock; each change is published as it is
+    // logged, and a batch once, when it is applied.
+    CatalogueVersions versions;
+    bool versionsReady;
+    DueIndex dueIndex; // every borrowed book by due date
+    unsigned loadThreads; // text import workers, 0 = one per core
 
 	// filepath for data
-    const std::string bookFile = "data/books.txt";
-    const std::string userFile = "data/users.txt";
+    const std::string bookFile;
+    const std::string userFile;
+    const std::string snapshotFile;
+    DataFormat format;
+    AccessMode access;
+    bool textExport;
+
+    // Every mutation is appended to the operation log; the base files above
+    // are only rewritten by checkpoints. Each base records the last LSN it
+    // contains so recovery replays exactly the records after it. An
+    // operation returns only once its records are fsynced.
+    OperationLog wal;
+    bool logging; // off while loading and replaying
+    uint64_t bookCheckpoint;
+    uint64_t userCheckpoint;
+
+    // Concurrent sessions: catalogue readers share stateLock, structural
+    // changes and checkpoints hold it exclusively. A book's loan state is
+    // guarded by its stripe in bookLocks (taken after stateLock).
+    static const size_t BOOK_LOCK_STRIPES = 256;
+    std::shared_mutex stateLock;
+    std::mutex bookLocks[BOOK_LOCK_STRIPES];
+    std::mutex loansLock;   // loansByMember, dueIndex, facet availability, versions
+    std::mutex historyLock; // member histories
+    bool batching;          // applyBatch() in progress: one version at the end
+    // Multi-step loan changes in progress (a return and its hand-over),
+    // under loansLock. Publishing waits until none is open, so no version
+    // shows one half-done; the last to close publishes for everyone.
+    size_t openChanges;
+    std::mutex& bookLock(BookHandle handle) { return bookLocks[handle % BOOK_LOCK_STRIPES]; }
+    // Called at the end of each operation, after any locks it held are
+    // released: waits until the operation's records are fsynced (sharing
+    // the fsync with concurrent sessions), then checkpoints if the log has
+    // outgrown the base
+    void commitOperation();
+
+    void loadTextData();
+    bool loadSnapshot();
+    void replayLog();
+    void applyLogRecord(const LogRecord& record);
+    void logOp(const std::string& op, std::initializer_list<std::string_view> fields);
+    void maybeCompact();
+    bool checkpoint(bool async);
+    std::string serializeBooks(uint64_t lsn) const;
+    std::string serializeUsers(uint64_t lsn) const;
 
     // Helpers
+    BookHandle addToCatalogue(Book book);
+    // Store, ID, facet and fuzzy indexes and log; the caller updates the search index
+    BookHandle storeBook(Book book);
+    void removeFromCatalogue(BookHandle handle);
+    void addUser(Person* user);
+    bool eraseUser(const std::string& id);
+    void reserveBook(BookHandle handle, const std::string& memberId);
+    std::string popReservation(BookHandle handle);
+    void recordHistory(Member* mem, std::string_view title, HistoryAction action);
+    // Checks the book in and lends it to the first reservation that still has
+    // an account; mem (the returning member, if known) gets the history entry
+    void returnAndHandOver(BookHandle handle, Member* mem);
+    void ensureSearchIndex();
+    void invalidateSearches(BookHandle handle); // before an add or remove is visible
+    void ensureFacets();
+    void ensureFuzzyIndex();
+    void ensureVersions();
+    void publishVersion(); // no-op before the first snapshot, in a batch or an open change
     Person* findUser(std::string id);
-    Book* findBook(std::string id);
-    void calculateFine(time_t dueDate);
+    BookHandle findBookHandle(const std::string& id) const;
+    // Lowest free numeric book ID, marked as taken
+    std::string allocateBookId();
+    // All loan state changes go through these so loansByMember stays in sync.
+    // With publish false the change waits for the caller's publishVersion().
+    void checkOut(BookHandle handle, const std::string& memberId, int daysToBorrow, time_t due = 0,
+                  bool publish = true);
+    void checkIn(BookHandle handle, bool publish = true);
 
 public:
-    LibrarySystem();
+    LibrarySystem(DataFormat format = DataFormat::Text, const std::string& dataDir = "data",
+                  unsigned loadThreads = 0, AccessMode access = AccessMode::ReadWrite);
     ~LibrarySystem();
 
     void loadData(); 
+    // Folds the operation log into fresh base files; a no-op when read-only
     void saveData();
+    // In binary mode, also write the text files on save
+    void setTextExport(bool enabled);
+
+    static constexpr double FINE_PER_DAY = 0.50;
+    static Fine fineFor(time_t dueDate, time_t returnedAt);
+
+    // The library API. It does no terminal I/O and returns copies, so the
+    // console, the server and benchmarks all drive it the same way. Every
+    // call is thread-safe once enableConcurrentSessions() has been called,
+    // which must happen before the object is shared between threads.
+    void enableConcurrentSessions();
+    // Matches title, author and genre words; an empty query lists the
+    // catalogue. Skips offset matches and returns at most limit.
+    // Repeated queries are answered from an LRU cache of ranked results.
+    std::vector<Book> search(const std::string& query, size_t offset = 0, size_t limit = SIZE_MAX);
+    SearchCacheStats searchCacheStats() const;
+    void setSearchCacheCapacity(size_t bytes); // 0 turns the cache off
+    // Every book and account as of the latest commit, in O(1). Reports can
+    // scan it for as long as they like without blocking borrowers or seeing
+    // a later change. Versions are only kept from the first call (or
+    // enableConcurrentSessions()) on; listings read one once they exist.
+    CatalogueSnapshot snapshot();
+    // Typo-tolerant: the k books whose title and author words are closest
+    // to the query words, best first
+    std::vector<FuzzyMatch> fuzzySearch(const std::string& query, size_t k = 10);
+    std::vector<Book> borrowedBy(const std::string& memberId);
+    // Entries with from <= time < to, skipping offset and returning at most limit
+    std::vector<HistoryEntry> historyOf(const std::string& memberId, time_t from, time_t to,
+                                        size_t offset, size_t limit);
+    size_t historySize(const std::string& memberId);
+    // A copy of the book with this ID; false if there is none
+    bool findBook(const std::string& id, Book& book);
+    bool findUserInfo(const std::string& id, UserInfo& info);
+    std::vector<UserInfo> listUsers(size_t offset = 0, size_t limit = SIZE_MAX); // librarians first
+    OpStatus borrow(const std::string& memberId, const std::string& bookId);
+    // Queues the member for a book that is currently out (Unavailable otherwise)
+    OpStatus reserve(const std::string& memberId, const std::string& bookId);
+    // Hands the book to the first reservation, if any, and reports the fine
+    ReturnResult returnBook(const std::string& memberId, const std::string& bookId);
+    // Adds the book under the lowest free numeric ID and returns that ID
+    std::string addBook(const std::string& title, const std::string& author, const std::string& genre);
+    OpStatus removeBook(const std::string& bookId);
+    OpStatus registerUser(Role role, const std::string& id, const std::string& name, const std::string& email);
+    OpStatus removeUser(const std::string& id); // NotAllowed for "admin"
+    // Books whose genre (or author) list has value, compared case-insensitively
+    std::vector<Book> browse(Facet facet, const std::string& value, size_t offset = 0, size_t limit = SIZE_MAX);
+    // Books and available books per value, most books first
+    std::vector<FacetCount> facetCounts(Facet facet);
+    bool facetCount(Facet facet, const std::string& value, FacetCount& count);
+    // Every loan due before asOf and its fine as of then; visits only the
+    // overdue loans, not the catalogue
+    OverdueReport overdueReport(time_t asOf);
 
-    // Menu Operations
-    bool run();
-    void librarianMenu(Librarian* lib);
-    void memberMenu(Member* mem);
-    void guestMenu();
-
-    // Core Features
-    void addBook();
-    void removeBook();
-    void displayAllBooks();
-    void registerUser();
-    void removeUser();
-	void displayAllUsers();
-    void borrowBook(Member* mem);
-    void returnBook(Member* mem);
-    bool searchBooks();
-    void displayBorrowedBooks(Member *mem);
-	void displayHistory(Member *mem);
+    // Validates every item against the current state (and the items before
+    // it), then applies all of them under one exclusive lock, logged between
+    // BATCH and COMMIT so recovery replays all or none, with one fsync at the
+    // end. Any invalid item rejects the whole batch. Safe to call from
+    // server sessions.
+    BatchResult applyBatch(const std::vector<BatchOp>& ops);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// Latency histograms and counters for the library operations, process-wide.
+//
+// Durations go into log-linear buckets (HDR style): exact below 32 ns, then
+// 32 buckets per power of two, so any quantile is within about 3% of the
+// true value. Recording is two relaxed atomic adds and takes no lock.
+//
+// Build with -DLIBRARY_NO_METRICS to compile every timer and counter out;
+// otherwise setEnabled(false) turns them off at run time, leaving one
+// relaxed load per call.
+class Metrics {
+public:
+    enum class Op { Load, Save, Search, FuzzySearch, FindBook, Borrow, Return, Reserve };
+    static const size_t OP_COUNT = 8;
+    enum class Counter {
+        Searches, Borrows, Returns, Reservations, Fines, FineCents, SearchCacheHits, SearchCacheMisses
+    };
+    static const size_t COUNTER_COUNT = 8;
+
+    static const char* opName(Op op);
+    static const char* counterName(Counter counter);
+
+    // One operation's latencies at the time of the call
+    struct Summary {
+        uint64_t count;
+        double sumMs;
+        // Upper bounds of the buckets holding each quantile
+        double p50Ms, p90Ms, p99Ms, p999Ms, maxMs;
+    };
+
+private:
+    static const unsigned SUB_BITS = 5; // buckets per power of two = 2^SUB_BITS
+    static const unsigned MAX_BITS = 40; // ~18 minutes in ns; longer is clamped
+    static const size_t BUCKETS = (MAX_BITS - SUB_BITS + 1) << SUB_BITS;
+
+    struct Histogram {
+        std::atomic<uint64_t> buckets[BUCKETS];
+        std::atomic<uint64_t> sumNs;
+    };
+    Histogram histograms[OP_COUNT];
+    std::atomic<uint64_t> counters[COUNTER_COUNT];
+    std::atomic<bool> on;
+
+    static size_t bucketOf(uint64_t ns);
+    static uint64_t bucketLimit(size_t bucket); // largest value in it
+
+public:
+    Metrics();
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    static Metrics& global();
+
+#ifdef LIBRARY_NO_METRICS
+    static constexpr bool enabled() { return false; }
+#else
+    static bool enabled() { return global().on.load(std::memory_order_relaxed); }
+#endif
+    void setEnabled(bool enabled) { on.store(enabled, std::memory_order_relaxed); }
+
+    void record(Op op, uint64_t ns) {
+        Histogram& h = histograms[static_cast<size_t>(op)];
+        h.buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+        h.sumNs.fetch_add(ns, std::memory_order_relaxed);
+    }
+    static void count(Counter counter, uint64_t n = 1) {
+        if (enabled()) global().counters[static_cast<size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    Summary summary(Op op) const;
+    uint64_t value(Counter counter) const;
+    void reset();
+
+    // The dump: a table for people, or the Prometheus text format
+    std::string text() const;
+    std::string prometheus() const;
+    bool writePrometheus(const std::string& path) const;
+};
+
+// Records the time from construction to destruction under op
+class ScopedTimer {
+private:
+    Metrics::Op op;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(Metrics::Op op) : op(op), active(Metrics::enabled()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+    ~ScopedTimer() {
+        if (!active) return;
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        Metrics::global().record(op, static_cast<uint64_t>(ns.count()));
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+#endif
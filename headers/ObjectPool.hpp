@@ -0,0 +1,114 @@
+#ifndef OBJECTPOOL_HPP
+#define OBJECTPOOL_HPP
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+// Slab allocator for objects of one type. Objects are constructed in place
+// inside fixed-size slabs and never move; destroyed cells go on a free list
+// and are reused first. Teardown runs the destructors in address order and
+// then frees whole slabs, one delete per SLAB_SIZE objects.
+template <typename T, size_t SLAB_SIZE = 256>
+class ObjectPool {
+private:
+    struct Cell {
+        union {
+            Cell* nextFree;
+            alignas(T) unsigned char object[sizeof(T)];
+        };
+        bool live;
+    };
+
+    std::vector<std::unique_ptr<Cell[]>> slabs;
+    size_t used;    // cells handed out from the last slab
+    Cell* freeList;
+    size_t count;
+
+    void release(Cell* cell) {
+        cell->live = false;
+        cell->nextFree = freeList;
+        freeList = cell;
+    }
+
+public:
+    ObjectPool() : used(SLAB_SIZE), freeList(nullptr), count(0) {}
+    ~ObjectPool() { clear(); }
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+    ObjectPool(ObjectPool&& other) noexcept
+        : slabs(std::move(other.slabs)), used(other.used), freeList(other.freeList), count(other.count) {
+        other.slabs.clear();
+        other.used = SLAB_SIZE;
+        other.freeList = nullptr;
+        other.count = 0;
+    }
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Cell* cell;
+        if (freeList) {
+            cell = freeList;
+            freeList = cell->nextFree;
+        } else {
+            if (used == SLAB_SIZE) {
+                slabs.emplace_back(new Cell[SLAB_SIZE]);
+                used = 0;
+            }
+            cell = &slabs.back()[used++];
+        }
+        T* object = new (cell->object) T(std::forward<Args>(args)...);
+        cell->live = true;
+        count++;
+        return object;
+    }
+
+    // object must have come from create() on this pool (or one it adopted)
+    void destroy(T* object) {
+        object->~T();
+        release(reinterpret_cast<Cell*>(object));
+        count--;
+    }
+
+    // Takes over every object of other, which is left empty. Pointers to
+    // those objects stay valid.
+    void adopt(ObjectPool& other) {
+        if (other.slabs.empty()) return;
+        // The unused tail of our current slab becomes free cells
+        if (!slabs.empty()) {
+            for (size_t i = used; i < SLAB_SIZE; i++) release(&slabs.back()[i]);
+        }
+        for (auto& slab : other.slabs) slabs.push_back(std::move(slab));
+        used = other.used;
+        while (other.freeList) {
+            Cell* cell = other.freeList;
+            other.freeList = cell->nextFree;
+            release(cell);
+        }
+        count += other.count;
+        other.slabs.clear();
+        other.used = SLAB_SIZE;
+        other.count = 0;
+    }
+
+    void clear() {
+        for (size_t s = 0; s < slabs.size(); s++) {
+            size_t cells = s + 1 == slabs.size() ? used : SLAB_SIZE;
+            for (size_t i = 0; i < cells; i++) {
+                Cell& cell = slabs[s][i];
+                if (cell.live) reinterpret_cast<T*>(cell.object)->~T();
+            }
+        }
+        slabs.clear();
+        used = SLAB_SIZE;
+        freeList = nullptr;
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t slabCount() const { return slabs.size(); }
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef OPERATIONLOG_HPP
+#define OPERATIONLOG_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <initializer_list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// One logged mutation: "lsn|op|field|...|crc32" per line
+struct LogRecord {
+    uint64_t lsn;
+    std::string op;
+    std::vector<std::string> fields;
+};
+
+// Append-only write-ahead log of catalogue/user mutations.
+// Records are written to the OS as soon as they are appended (so they
+// survive a process crash). A flusher thread fsyncs them: at once when a
+// committing caller waits in waitDurable(), otherwise every
+// syncIntervalMs. Callers that wait while an fsync is running share the
+// next one, so a burst of operations commits with a single fsync.
+// A checkpoint rotates the live log to "<path>.1"; once the new base
+// snapshot is durable the rotated segment is deleted.
+class OperationLog {
+private:
+    std::string path;
+    std::string rotatedPath;
+    unsigned syncIntervalMs;
+    int fd;
+
+    std::mutex mtx;
+    std::condition_variable flushCv;   // wakes the flusher
+    std::condition_variable durableCv; // wakes sync() and waitDurable() callers
+    uint64_t nextLsn;
+    uint64_t writtenLsn;
+    uint64_t durableLsn;
+    size_t sinceCheckpoint;
+    bool syncRequested;
+    bool stopping;
+    bool writeFailed;
+    std::thread flusher;
+
+    std::thread compactor;
+    bool compacting;
+
+    // Bytes of the live log up to its last good record, as found by replay()
+    size_t liveGoodBytes;
+    bool liveScanned;
+
+    void flushLoop();
+    void waitDurable(std::unique_lock<std::mutex>& lock, uint64_t lsn);
+    bool rotate();
+    void stopFlusher();
+
+public:
+    OperationLog(const std::string& path, unsigned syncIntervalMs = 20);
+    ~OperationLog();
+    OperationLog(const OperationLog&) = delete;
+    OperationLog& operator=(const OperationLog&) = delete;
+
+    // Opens the live log for appending; LSNs continue after firstLsn - 1.
+    // After replay(), a torn or corrupt tail is cut off first, so new
+    // records are not written behind a line replay would stop at.
+    bool open(uint64_t firstLsn);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // Replays the rotated segment then the live log in order. Stops at the
+    // first torn or corrupt line (an interrupted final write). Returns the
+    // highest LSN seen, or 0 if there were no records.
+    uint64_t replay(const std::function<void(const LogRecord&)>& apply);
+
+    // Returns the record's LSN, or 0 if the log is not open or the write failed
+    uint64_t append(const std::string& op, std::initializer_list<std::string_view> fields);
+    // Blocks until every record appended so far has been fsynced
+    void sync();
+    // Blocks until the record with this LSN, and all before it, has been
+    // fsynced (group commit: concurrent waiters share one fsync)
+    void waitDurable(uint64_t lsn);
+
+    uint64_t lastLsn();
+    size_t recordsSinceCheckpoint();
+    bool compactionRunning();
+
+    // Rotates the log and runs writeBase, which must persist a base holding
+    // everything up to lastLsn() (the caller serializes before calling and
+    // appends nothing in between). With async the writer runs on a
+    // background thread and owns whatever it captured; false means a
+    // previous compaction is still running. Synchronous checkpoints return
+    // whether the base was written.
+    bool checkpoint(const std::function<bool()>& writeBase, bool async);
+    void waitForCompaction();
+
+    // Writes data to path via fsynced temporary file + rename
+    static bool writeFileAtomic(const std::string& path, const std::string& data);
+};
+
+#endif
@@ -2,59 +2,76 @@
 #define PERSON_HPP
 
 #include <string>
+#include <string_view>
 #include <iostream>
-#include <list>
+#include <ctime>
+#include <cstdint>
+#include "HistoryLog.hpp"
 
-// Base Class
+// Compact role tag stored in every Person; replaces RTTI and role strings
+enum class Role : uint8_t { Librarian, Member, Guest };
+
+std::string_view roleName(Role role); // "Librarian", "Member", "Guest"
+
+// Base Class. Not polymorphic: code that needs the concrete type checks
+// role() and uses asMember()/asLibrarian(), and the owning UserStore
+// destroys each object as its own type.
 class Person {
 protected:
     std::string id;
     std::string name;
     std::string email;
+    Role roleTag;
+
+    Person(Role role, std::string id, std::string name, std::string email);
+    ~Person() {}
 
 public:
-    Person(std::string id, std::string name, std::string email);
-    virtual ~Person() {}
-
-    std::string getId() const;
-    std::string getName() const;
-	std::string getEmail() const;
-    
-    virtual std::string getRole() const = 0; 
-    virtual std::string toFileString() const = 0;
+    const std::string& getId() const { return id; }
+    const std::string& getName() const { return name; }
+    const std::string& getEmail() const { return email; }
+
+    Role role() const { return roleTag; }
+    std::string_view getRole() const { return roleName(roleTag); }
 };
 
 // Derived Class: Librarian
 class Librarian : public Person {
 public:
     Librarian(std::string id, std::string name, std::string email);
-    std::string getRole() const override;
-    std::string toFileString() const override;
+    std::string toFileString() const;
 };
 
 // Derived Class: Member
 class Member : public Person {
 private:
-    std::list<std::string> borrowingHistory; 
+    HistoryLog borrowingHistory;
 
 public:
     Member(std::string id, std::string name, std::string email);
-    std::string getRole() const override;
-    
-	void addToHistory(std::string bookTitle, std::string action);
-
-	std::list<std::string> getHistory() const;
-    std::string toFileString() const override;
-    
-    void loadHistory(const std::string& historyStr);
+
+	// Stamps the entry with the current time and returns it
+	HistoryEntry addToHistory(std::string_view bookTitle, HistoryAction action);
+
+	const HistoryLog& getHistory() const;
+    std::string toFileString() const;
+
+    void loadHistory(std::string_view historyStr);
+    void appendHistory(time_t time, HistoryAction action, std::string_view bookTitle);
 };
 
-// Derived Class: Guest
+// Derived Class: Guest (never stored or saved)
 class Guest : public Person {
 public:
     Guest();
-    std::string getRole() const override;
-    std::string toFileString() const override;
 };
 
-#endif
\ No newline at end of file
+// Checked downcasts by role tag; nullptr if user is null or has another role
+inline Member* asMember(Person* user) {
+    return user && user->role() == Role::Member ? static_cast<Member*>(user) : nullptr;
+}
+inline Librarian* asLibrarian(Person* user) {
+    return user && user->role() == Role::Librarian ? static_cast<Librarian*>(user) : nullptr;
+}
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef RESERVATIONQUEUE_HPP
+#define RESERVATIONQUEUE_HPP
+
+#include "StringPool.hpp"
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+// FIFO of member IDs waiting for a book, held as StringPool handles. Any
+// number of threads may push() at once without locking: producers CAS onto
+// an incoming stack. Everything
+// else (pop, iteration, copying) is the consumer side and must be
+// serialized by the caller (LibrarySystem holds the book's lock); the
+// consumer moves the incoming stack, reversed, onto its own FIFO list.
+// An empty queue is three null pointers and allocates nothing.
+class ReservationQueue {
+private:
+    struct Node {
+        StringPool::Handle memberId;
+        Node* next;
+    };
+
+    mutable std::atomic<Node*> incoming; // newest first
+    mutable Node* head;                  // consumer FIFO, oldest first
+    mutable Node* tail;
+
+    void settle() const;
+    void destroy();
+    void copyFrom(const ReservationQueue& other);
+
+public:
+    class const_iterator {
+    private:
+        const Node* node;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::string_view value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::string_view* pointer;
+        typedef std::string_view reference;
+
+        explicit const_iterator(const Node* node) : node(node) {}
+        std::string_view operator*() const { return StringPool::global().view(node->memberId); }
+        const_iterator& operator++() {
+            node = node->next;
+            return *this;
+        }
+        bool operator==(const const_iterator& o) const { return node == o.node; }
+        bool operator!=(const const_iterator& o) const { return node != o.node; }
+    };
+
+    ReservationQueue();
+    ~ReservationQueue();
+    // Copies and moves are consumer-side operations on both queues
+    ReservationQueue(const ReservationQueue& other);
+    ReservationQueue(ReservationQueue&& other) noexcept;
+    ReservationQueue& operator=(const ReservationQueue& other);
+    ReservationQueue& operator=(ReservationQueue&& other) noexcept;
+
+    // Lock-free; safe from any thread
+    void push(std::string_view memberId);
+
+    // Consumer side
+    bool pop(std::string& memberId);
+    // Removes the first entry for memberId
+    bool remove(std::string_view memberId);
+    bool empty() const;
+    size_t size() const;
+    void clear();
+    const_iterator begin() const {
+        settle();
+        return const_iterator(head);
+    }
+    const_iterator end() const { return const_iterator(nullptr); }
+};
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef SEARCHCACHE_HPP
+#define SEARCHCACHE_HPP
+
+#include "BookStore.hpp"
+#include "HashIndex.hpp"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct SearchCacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations; // entries dropped because a matching book was added or removed
+    uint64_t evictions;     // entries dropped to stay under the capacity
+    size_t entries;
+    size_t bytes;
+    size_t capacity;
+};
+
+// Least-recently-used cache of ranked search results, keyed on the query's
+// sorted words so "Potter harry" and "harry  potter" share an entry.
+//
+// An entry holds book handles only; callers copy the books when they read
+// it, so a borrow or return never makes an entry stale. Results depend on
+// the ID, title, author and genre words, which change only when a book is
+// added or removed: invalidate() drops exactly the entries whose every
+// query word is a prefix of one of that book's words, found through the
+// entries' longest word.
+//
+// Thread-safe; the owner makes sure a search and the invalidation for a
+// change to its results cannot interleave.
+class SearchCache {
+public:
+    typedef std::shared_ptr<const std::vector<BookHandle>> Results;
+
+private:
+    struct Entry {
+        std::string key;
+        std::vector<std::string> terms; // sorted
+        Results books;
+        size_t bytes;
+    };
+    std::list<Entry> lru; // most recently used first
+    HashIndex<std::list<Entry>::iterator> byKey;
+    HashIndex<std::vector<Entry*>> byTerm; // by each entry's longest term
+    size_t bytes;
+    size_t capacity;
+    uint64_t hits, misses, invalidations, evictions;
+    mutable std::mutex mtx;
+
+    static const std::string& indexTerm(const Entry& entry);
+    void drop(std::list<Entry>::iterator it);
+
+public:
+    explicit SearchCache(size_t capacityBytes = 8 << 20);
+    SearchCache(const SearchCache&) = delete;
+    SearchCache& operator=(const SearchCache&) = delete;
+
+    // The cache key for a query's words: sorted, space separated
+    static std::string normalize(std::vector<std::string>& terms);
+
+    // The cached results for key, or null (counted as a miss)
+    Results find(const std::string& key);
+    // Results larger than a quarter of the capacity are not kept
+    void insert(const std::string& key, const std::vector<std::string>& terms, Results books);
+    // Drops the entries a book with these words (sorted, as collectTerms
+    // gives them) would match
+    void invalidate(const std::vector<std::string>& bookTerms);
+    void clear();
+    // 0 turns caching off
+    void setCapacity(size_t capacityBytes);
+    SearchCacheStats stats() const;
+};
+
+#endif
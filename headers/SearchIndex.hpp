@@ -0,0 +1,46 @@
+#ifndef SEARCHINDEX_HPP
+#define SEARCHINDEX_HPP
+
+#include "BookStore.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+
+struct SearchResult {
+    BookHandle book;
+    int score;
+};
+
+// Tokenized inverted index over book ID, title, author and genre.
+// Queries are whitespace separated terms, each matched as a word prefix,
+// and all terms must match (AND).
+class SearchIndex {
+private:
+    const BookStore& books;
+    // term -> handles of books containing it, sorted for binary search
+    std::map<std::string, std::vector<BookHandle>> postings;
+
+    static int scoreTerm(const Book& book, const std::string& term);
+
+public:
+    explicit SearchIndex(const BookStore& books);
+
+    // Lowercase words of text, as queries and books are split
+    static std::vector<std::string> tokenize(std::string_view text);
+    // The distinct words of a book's ID, title, author and genre, sorted
+    static void collectTerms(const Book& book, std::vector<std::string>& terms);
+
+    void add(BookHandle handle);
+    // Same as add() for each handle, but cheaper for many books at once
+    void addAll(const std::vector<BookHandle>& handles);
+    void remove(BookHandle handle); // call before the book leaves the store
+    void clear();
+
+    size_t termCount() const;
+
+    // Ranked by score (highest first), ties broken by book ID
+    std::vector<SearchResult> search(const std::string& query) const;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "BookStore.hpp"
+#include "UserStore.hpp"
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+// Binary catalogue snapshot: a fast import format. Fixed-size records point
+// into a shared string heap, so loading is a walk over mapped arrays with no
+// parsing; the in-memory indexes are rebuilt from it. All sections are
+// 8-byte aligned and stored in host byte order (checked through endianTag).
+
+// Version 4 drops the ID tables, which nothing looked up. Version 3 stores
+// history as fixed records; version 2 files (history as
+// "timestamp|action|title" strings) are still readable
+const uint32_t SNAPSHOT_VERSION = 4;
+const uint32_t SNAPSHOT_MIN_VERSION = 2;
+
+struct SnapString {
+    uint32_t offset; // into the string heap
+    uint32_t length;
+};
+
+struct SnapHeader {
+    char magic[8]; // "SLIBSNAP"
+    uint32_t version;
+    uint32_t endianTag;
+    uint64_t fileSize;
+    uint64_t bookCount, booksOffset;
+    uint64_t userCount, usersOffset;
+    uint64_t reservationCount, reservationsOffset;
+    uint64_t historyCount, historyOffset;
+    uint64_t bookTableSize, bookTableOffset; // ID tables; versions 2-3 only, skipped
+    uint64_t userTableSize, userTableOffset;
+    uint64_t stringsSize, stringsOffset;
+    uint64_t logSequence; // last operation-log record folded into this snapshot
+};
+
+struct SnapBook {
+    SnapString id, title, author, genre, borrower;
+    int64_t dueDate;
+    uint32_t reservationBegin, reservationCount; // into the reservation array
+    uint32_t borrowed;
+    uint32_t reserved;
+};
+
+struct SnapHistory {
+    int64_t time;
+    SnapString title; // the whole entry for SNAP_HISTORY_UNPARSED
+    uint32_t action; // HistoryAction or SNAP_HISTORY_UNPARSED
+    uint32_t reserved;
+};
+
+// A legacy history entry that did not parse, kept verbatim
+const uint32_t SNAP_HISTORY_UNPARSED = UINT32_MAX;
+
+enum SnapRole : uint32_t { SNAP_LIBRARIAN = 1, SNAP_MEMBER = 2 };
+
+struct SnapUser {
+    SnapString id, name, email;
+    uint32_t role;
+    uint32_t historyBegin, historyCount; // into the history array
+    uint32_t reserved;
+};
+
+// Serializes books and users; empty if the string heap would overflow
+std::string buildSnapshot(const BookStore& books, const UserStore& users, uint64_t logSequence);
+// Builds and writes the snapshot to path (via a temporary file and rename)
+bool writeSnapshot(const std::string& path, const BookStore& books, const UserStore& users,
+                   uint64_t logSequence = 0);
+
+// Read-only memory-mapped view of a snapshot file
+class SnapshotView {
+private:
+    const char* base;
+    size_t length;
+    const SnapHeader* header;
+
+    template <typename T>
+    const T* section(uint64_t offset) const { return reinterpret_cast<const T*>(base + offset); }
+    bool recordsFit() const;
+
+public:
+    SnapshotView();
+    ~SnapshotView();
+    SnapshotView(const SnapshotView&) = delete;
+    SnapshotView& operator=(const SnapshotView&) = delete;
+
+    // Maps and validates the file; false if missing, truncated, wrong version
+    // or if a record's reservations or history run past their section
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    uint32_t version() const { return header->version; }
+    uint64_t logSequence() const { return header->logSequence; }
+    size_t bookCount() const { return header->bookCount; }
+    size_t userCount() const { return header->userCount; }
+    const SnapBook& book(size_t i) const { return section<SnapBook>(header->booksOffset)[i]; }
+    const SnapUser& user(size_t i) const { return section<SnapUser>(header->usersOffset)[i]; }
+    const SnapString& reservation(size_t i) const { return section<SnapString>(header->reservationsOffset)[i]; }
+    const SnapHistory& history(size_t i) const { return section<SnapHistory>(header->historyOffset)[i]; }
+    const SnapString& historyV2(size_t i) const { return section<SnapString>(header->historyOffset)[i]; }
+    std::string_view str(const SnapString& s) const;
+};
+
+#endif
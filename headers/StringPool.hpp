@@ -0,0 +1,71 @@
+#ifndef STRINGPOOL_HPP
+#define STRINGPOOL_HPP
+
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+// Process-wide table of immutable strings. intern() hands out a compact
+// handle that is the same for equal strings; handle 0 is the empty string.
+// Strings are never freed, so views stay valid for the life of the process.
+// view() is lock-free. intern() locks one of 16 shards (picked by hash), so
+// parallel loaders rarely wait on each other.
+class StringPool {
+public:
+    typedef uint32_t Handle;
+
+private:
+    struct Entry {
+        const char* data;
+        uint32_t length;
+    };
+    static const unsigned SHARD_BITS = 4;  // low bits of a handle
+    static const unsigned CHUNK_BITS = 12; // entries per chunk
+    static const size_t MAX_CHUNKS = 1 << 12;  // 16M strings per shard
+    static const size_t BLOCK_BYTES = 64 * 1024;
+
+    struct Shard {
+        // index -> entry, in fixed chunks so published entries never move
+        std::unique_ptr<std::atomic<Entry*>[]> chunks;
+        std::vector<std::unique_ptr<Entry[]>> ownedChunks;
+        uint32_t count = 0;
+
+        // Character storage, appended to in blocks
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char* block = nullptr; // the one short strings are appended to
+        size_t blockUsed = BLOCK_BYTES;
+        size_t totalBytes = 0;
+
+        // Open-addressing set of handles, probed by string hash
+        std::vector<Handle> slots;
+        std::mutex mtx;
+    };
+    Shard shards[1 << SHARD_BITS];
+
+    static const char* store(Shard& shard, std::string_view s);
+    void grow(Shard& shard);
+
+public:
+    StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    static StringPool& global();
+
+    Handle intern(std::string_view s);
+    std::string_view view(Handle handle) const {
+        const Shard& shard = shards[handle & ((1u << SHARD_BITS) - 1)];
+        uint32_t index = handle >> SHARD_BITS;
+        const Entry& e = shard.chunks[index >> CHUNK_BITS].load(std::memory_order_acquire)[index & ((1u << CHUNK_BITS) - 1)];
+        return std::string_view(e.data, e.length);
+    }
+
+    size_t size();
+    size_t bytes(); // characters plus table overhead
+};
+
+#endif
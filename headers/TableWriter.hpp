@@ -0,0 +1,81 @@
+#ifndef TABLEWRITER_HPP
+#define TABLEWRITER_HPP
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ctime>
+#include <cstddef>
+
+// Text is the padded console table; Tsv and Json are for piping
+enum class TableFormat { Text, Tsv, Json };
+
+// "text", "tsv" or "json"; false for anything else
+bool parseTableFormat(std::string_view name, TableFormat& format);
+
+// Formats dates with strftime, calling localtime()/strftime() once per
+// quarter hour of input instead of once per row. Every zone offset in use
+// is a multiple of 15 minutes, so a local day never splits a quarter hour.
+class DateCache {
+private:
+    static const size_t SLOTS = 1024; // direct-mapped on the quarter hour
+    struct Slot {
+        long long quarter;
+        unsigned char length;
+        char text[23];
+    };
+    std::vector<Slot> slots;
+    const char* pattern;
+
+public:
+    explicit DateCache(const char* pattern);
+    std::string_view format(time_t t);
+};
+
+struct TableColumn {
+    const char* name;
+    size_t width;          // Text only; 0 leaves the column unpadded (use it last)
+    const char* key = 0;   // Tsv header / Json key, if different from name
+};
+
+// Renders rows into one reusable buffer and writes it out in large chunks.
+// Text cells are padded or cut to width with "..." in place, with no
+// temporary strings. The header is written by the constructor and the
+// closing rule (or "]") by finish(), which the destructor calls if needed.
+class TableWriter {
+private:
+    static const size_t FLUSH_AT = 64 * 1024;
+    std::ostream& out;
+    TableFormat format;
+    std::vector<TableColumn> columns;
+    size_t ruleWidth;
+    std::string buf;
+    size_t column; // next cell in the current row
+    size_t rows;
+    bool finished;
+    DateCache dates;
+
+    void rule();
+    void startCell();
+    void append(std::string_view text);
+    void flushIfFull();
+
+public:
+    // ruleWidth is the length of the Text format's '-' rules
+    TableWriter(std::ostream& out, TableFormat format, std::vector<TableColumn> columns, size_t ruleWidth);
+    ~TableWriter();
+    TableWriter(const TableWriter&) = delete;
+    TableWriter& operator=(const TableWriter&) = delete;
+
+    void cell(std::string_view text);
+    void cell(long long value);
+    void cell(double value, int decimals);
+    // Text shows "Jan 01 2025", Tsv and Json "2025-01-01"
+    void dateCell(time_t t);
+    void endRow();
+    void finish();
+    size_t rowCount() const { return rows; }
+};
+
+#endif
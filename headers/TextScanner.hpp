@@ -0,0 +1,72 @@
+#ifndef TEXTSCANNER_HPP
+#define TEXTSCANNER_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <vector>
+
+// Allocation-free helpers for the pipe/comma delimited data files.
+// Everything hands out std::string_view slices of the caller's buffer.
+
+// First occurrence of c in [begin, end), or end. Vectorized with SSE2/AVX2.
+const char* findByte(const char* begin, const char* end, char c);
+
+// Parses a whole field as a signed integer with at most one leading sign
+// ("+5", "-5"); false on empty/invalid input
+bool parseInt(std::string_view text, long long& out);
+
+// Read-only view of a whole file: mmap when possible, otherwise read into
+// an owned buffer
+class MappedFile {
+private:
+    const char* data;
+    size_t length;
+    bool mapped;
+    std::string fallback;
+
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    std::string_view view() const { return std::string_view(data, length); }
+};
+
+// Splits text on one delimiter with std::getline semantics: "a||b" gives
+// "a", "", "b", and a trailing delimiter does not produce an empty field
+class FieldSplitter {
+private:
+    const char* pos;
+    const char* end;
+    char delim;
+
+public:
+    FieldSplitter(std::string_view text, char delim = '|');
+    bool next(std::string_view& field);
+    // Everything not yet consumed
+    std::string_view rest() const { return std::string_view(pos, end - pos); }
+};
+
+// Splits text into at most maxFields fields; returns the number written
+size_t splitFields(std::string_view text, char delim, std::string_view* out, size_t maxFields);
+
+// Cuts text into at most `parts` pieces of similar size, each ending on a line
+// boundary, so they can be parsed independently
+std::vector<std::string_view> splitAtLines(std::string_view text, size_t parts);
+
+// Iterates the lines of a buffer (without the '\n')
+class LineReader {
+private:
+    const char* pos;
+    const char* end;
+
+public:
+    explicit LineReader(std::string_view text);
+    bool next(std::string_view& line);
+};
+
+#endif
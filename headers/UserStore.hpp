@@ -0,0 +1,44 @@
+#ifndef USERSTORE_HPP
+#define USERSTORE_HPP
+
+#include "Person.hpp"
+#include "ObjectPool.hpp"
+#include <string>
+#include <vector>
+
+// Owns every user, grouped by role. Librarians and Members are built in
+// slab pools rather than with one new each, and each role has its own list
+// in insertion order, so per-role work (saving all members, say) is a plain
+// loop over one concrete type with no role checks.
+class UserStore {
+private:
+    ObjectPool<Librarian> librarianPool;
+    ObjectPool<Member> memberPool;
+    std::vector<Librarian*> librarianList;
+    std::vector<Member*> memberList;
+
+public:
+    UserStore() {}
+    UserStore(const UserStore&) = delete;
+    UserStore& operator=(const UserStore&) = delete;
+    UserStore(UserStore&&) = default;
+
+    // Construct a user owned by this store; add() lists it
+    Librarian* newLibrarian(std::string id, std::string name, std::string email);
+    Member* newMember(std::string id, std::string name, std::string email);
+    void add(Person* user);
+    // Unlists and destroys a user constructed by this store
+    void erase(Person* user);
+    // Takes over every user other constructed (listed or not); listed ones
+    // are appended to ours. other is left empty.
+    void adopt(UserStore& other);
+    void clear();
+
+    const std::vector<Librarian*>& librarians() const { return librarianList; }
+    const std::vector<Member*>& members() const { return memberList; }
+    size_t size() const { return librarianList.size() + memberList.size(); }
+    bool empty() const { return librarianList.empty() && memberList.empty(); }
+    size_t slabCount() const { return librarianPool.slabCount() + memberPool.slabCount(); }
+};
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef VERSIONEDTABLE_HPP
+#define VERSIONEDTABLE_HPP
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Rows by slot number, kept as a persistent 64-way trie so readers can hold
+// a committed version and scan it with no locks while the writer goes on.
+//
+// A write copies the nodes on its path that belong to a published version;
+// nodes created since the last publish() are not visible to anyone yet and
+// are updated in place, so a batch of writes between two publishes copies
+// each path once. publish() freezes the current tree as a Version.
+//
+// Nodes a write replaced may still be reachable from the published
+// versions up to the current one. They are queued with that version and
+// freed by a later publish() once no reader holds it or an older one, so
+// readers never touch a reference count per row or take a lock.
+//
+// One writer at a time (the owner's lock); Versions may be read and
+// released on any thread, but not after the table is destroyed. Row must
+// be copyable and default constructible.
+template <typename Row>
+class VersionedTable {
+private:
+    static const unsigned BITS = 6;
+    static const uint32_t FANOUT = 1u << BITS;
+
+    struct Node {
+        uint64_t generation; // publish() count when it was created
+    };
+    struct Leaf : Node {
+        uint64_t present; // bit i: rows[i] is set
+        Row rows[FANOUT];
+    };
+    struct Inner : Node {
+        Node* children[FANOUT];
+    };
+
+public:
+    class Version {
+    private:
+        friend class VersionedTable;
+        const Node* root;
+        unsigned depth; // inner levels above the leaves
+        size_t count;
+        // Set when the last Pin goes; the table frees the object itself
+        mutable std::atomic<bool> released;
+
+        Version(const Node* root, unsigned depth, size_t count)
+            : root(root), depth(depth), count(count), released(false) {}
+        static void release(const Version* version) { version->released.store(true, std::memory_order_release); }
+
+        // fn(slot, row) in slot order until it returns false
+        template <typename F>
+        static bool visit(const Node* node, unsigned level, uint32_t base, F& fn) {
+            if (!node) return true;
+            if (level == 0) {
+                const Leaf* leaf = static_cast<const Leaf*>(node);
+                for (uint64_t bits = leaf->present; bits; bits &= bits - 1) {
+                    unsigned i = __builtin_ctzll(bits);
+                    if (!fn(base + i, leaf->rows[i])) return false;
+                }
+                return true;
+            }
+            const Inner* inner = static_cast<const Inner*>(node);
+            for (uint32_t i = 0; i < FANOUT; i++)
+                if (!visit(inner->children[i], level - 1, base + (i << (BITS * level)), fn)) return false;
+            return true;
+        }
+
+    public:
+        Version(const Version&) = delete;
+        Version& operator=(const Version&) = delete;
+
+        size_t size() const { return count; }
+
+        template <typename F>
+        void forEach(F fn) const {
+            visit(root, depth, 0, fn);
+        }
+
+        const Row* find(uint32_t slot) const {
+            if (!root || (uint64_t(slot) >> (BITS * (depth + 1))) != 0) return nullptr;
+            const Node* node = root;
+            for (unsigned level = depth; level > 0 && node; level--)
+                node = static_cast<const Inner*>(node)->children[(slot >> (BITS * level)) & (FANOUT - 1)];
+            if (!node) return nullptr;
+            const Leaf* leaf = static_cast<const Leaf*>(node);
+            unsigned i = slot & (FANOUT - 1);
+            return (leaf->present >> i & 1) ? &leaf->rows[i] : nullptr;
+        }
+    };
+    typedef std::shared_ptr<const Version> Pin;
+
+private:
+    Node* root;
+    unsigned depth;
+    size_t count;
+    uint64_t generation;
+    bool changed; // since the last publish
+    std::vector<Leaf*> retiredLeaves; // replaced since the last publish
+    std::vector<Inner*> retiredInners;
+    std::shared_ptr<const Version> latest;
+
+    // Nodes replaced after each superseded version was published, oldest
+    // first; freeable once that version and all older ones are released
+    struct Retired {
+        const Version* version;
+        std::vector<Leaf*> leaves;
+        std::vector<Inner*> inners;
+    };
+    std::deque<Retired> retired;
+
+    static void destroy(Retired& r) {
+        for (Leaf* leaf : r.leaves) delete leaf;
+        for (Inner* inner : r.inners) delete inner;
+        delete r.version;
+    }
+
+    template <typename N>
+    N* own(Node* node, std::vector<N*>& retired) {
+        if (!node) {
+            N* fresh = new N();
+            fresh->generation = generation;
+            return fresh;
+        }
+        N* current = static_cast<N*>(node);
+        if (current->generation == generation) return current;
+        N* copy = new N(*current);
+        copy->generation = generation;
+        retired.push_back(current);
+        return copy;
+    }
+
+    // Returns the leaf for slot with writable nodes on its path, creating
+    // missing ones
+    Leaf* path(uint32_t slot) {
+        while ((uint64_t(slot) >> (BITS * (depth + 1))) != 0) {
+            if (root) {
+                Inner* up = own<Inner>(nullptr, retiredInners);
+                up->children[0] = root;
+                root = up;
+            }
+            depth++;
+        }
+        Node** link = &root;
+        for (unsigned level = depth; level > 0; level--) {
+            Inner* inner = own<Inner>(*link, retiredInners);
+            *link = inner;
+            link = &inner->children[(slot >> (BITS * level)) & (FANOUT - 1)];
+        }
+        Leaf* leaf = own<Leaf>(*link, retiredLeaves);
+        *link = leaf;
+        return leaf;
+    }
+
+    void discard(Node* node, unsigned level) {
+        if (!node) return;
+        if (level > 0)
+            for (Node* child : static_cast<Inner*>(node)->children) discard(child, level - 1);
+        if (level > 0) {
+            Inner* inner = static_cast<Inner*>(node);
+            if (inner->generation == generation) delete inner;
+            else retiredInners.push_back(inner);
+        } else {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            if (leaf->generation == generation) delete leaf;
+            else retiredLeaves.push_back(leaf);
+        }
+    }
+
+public:
+    VersionedTable() : root(nullptr), depth(0), count(0), generation(0), changed(true) {}
+    VersionedTable(const VersionedTable&) = delete;
+    VersionedTable& operator=(const VersionedTable&) = delete;
+    ~VersionedTable() {
+        clear();
+        publish();
+        const Version* last = latest.get();
+        latest.reset();
+        delete last;
+        for (Retired& r : retired) destroy(r);
+    }
+
+    size_t size() const { return count; }
+
+    void set(uint32_t slot, const Row& row) {
+        changed = true;
+        Leaf* leaf = path(slot);
+        unsigned i = slot & (FANOUT - 1);
+        if (!(leaf->present >> i & 1)) count++;
+        leaf->present |= uint64_t(1) << i;
+        leaf->rows[i] = row;
+    }
+
+    void erase(uint32_t slot) {
+        if ((uint64_t(slot) >> (BITS * (depth + 1))) != 0) return;
+        const Node* node = root;
+        for (unsigned level = depth; level > 0 && node; level--)
+            node = static_cast<const Inner*>(node)->children[(slot >> (BITS * level)) & (FANOUT - 1)];
+        unsigned i = slot & (FANOUT - 1);
+        if (!node || !(static_cast<const Leaf*>(node)->present >> i & 1)) return;
+        changed = true;
+        Leaf* leaf = path(slot);
+        leaf->present &= ~(uint64_t(1) << i);
+        leaf->rows[i] = Row();
+        count--;
+    }
+
+    void clear() {
+        changed = true;
+        discard(root, depth);
+        root = nullptr;
+        depth = 0;
+        count = 0;
+    }
+
+    // Freezes the rows as they are now; later writes leave it unchanged
+    Pin publish() {
+        if (!changed) return latest;
+        changed = false;
+        if (latest) retired.push_back(Retired{latest.get(), std::move(retiredLeaves), std::move(retiredInners)});
+        // With no earlier version nothing can have been retired
+        retiredLeaves.clear();
+        retiredInners.clear();
+        latest.reset(new Version(root, depth, count), Version::release);
+        generation++;
+        // The acquire pairs with release(), so the readers' last reads of a
+        // version happen before its nodes are deleted
+        while (!retired.empty() && retired.front().version->released.load(std::memory_order_acquire)) {
+            destroy(retired.front());
+            retired.pop_front();
+        }
+        return latest;
+    }
+};
+
+#endif
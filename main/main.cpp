@@ -1,11 +1,189 @@
 #include "LibrarySystem.hpp"
+#include "LibraryServer.hpp"
+#include "LibraryConsole.hpp"
+#include "TextScanner.hpp"
+#include "Metrics.hpp"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <ctime>
+
+static int runBatch(const std::string& path, DataFormat format, bool exportText, unsigned threads) {
+    std::vector<BatchOp> ops;
+    std::vector<BatchError> errors;
+    if (!readBatchFile(path, ops, errors)) {
+        std::cerr << "[Error] Could not read " << path << "\n";
+        return 1;
+    }
+    for (const BatchError& e : errors) std::cerr << path << ":" << e.line << ": " << e.reason << "\n";
+    if (!errors.empty()) {
+        std::cerr << "Batch rejected; nothing was changed.\n";
+        return 1;
+    }
+
+    LibrarySystem app(format, "data", threads);
+    app.setTextExport(exportText);
+    auto t0 = std::chrono::steady_clock::now();
+    BatchResult result = app.applyBatch(ops);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    for (const BatchError& e : result.errors) std::cerr << path << ":" << e.line << ": " << e.reason << "\n";
+    if (!result.applied) {
+        std::cerr << "Batch rejected; nothing was changed.\n";
+        return 1;
+    }
+    std::cout << "Applied " << ops.size() << " items (" << result.added << " added, " << result.borrowed
+              << " borrowed, " << result.returned << " returned) in " << seconds * 1000 << " ms, "
+              << static_cast<long long>(ops.size() / (seconds > 0 ? seconds : 1e-9)) << " items/s\n";
+    return 0;
+}
+
+// Writes the Prometheus dump when main returns, after the library has saved
+struct MetricsFile {
+    std::string path;
+    bool write() const { return path.empty() || Metrics::global().writePrometheus(path); }
+    ~MetricsFile() {
+        if (!write()) std::cerr << "[Error] Could not write " << path << "\n";
+    }
+};
+
+// Far more than any machine has cores; keeps a typo from spawning millions
+static const long long MAX_LOAD_THREADS = 1024;
+
+static bool parseFacet(const char* name, Facet& facet) {
+    if (std::strcmp(name, "genre") == 0) facet = Facet::Genre;
+    else if (std::strcmp(name, "author") == 0) facet = Facet::Author;
+    else return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    DataFormat format = DataFormat::Text;
+    bool exportText = false;
+    long long threadCount = 0; // 0 = one per core
+    std::string serveSocket;
+    std::string batchFile;
+    std::string listWhat, query; // --list / --search
+    bool listing = false;
+    TableFormat tableFormat = TableFormat::Text;
+    long long offset = 0, limit = -1;
+    long long asOf = time(0);
+    Facet facet = Facet::Genre;
+    MetricsFile metrics;
+    long long cacheMb = 8;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--binary") == 0) format = DataFormat::Binary;
+        else if (std::strcmp(argv[i], "--export-text") == 0) exportText = true;
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc && parseInt(argv[i + 1], threadCount) &&
+                 threadCount > 0 && threadCount <= MAX_LOAD_THREADS) i++;
+        else if (std::strcmp(argv[i], "--serve") == 0 && i + 1 < argc) serveSocket = argv[++i];
+        else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) batchFile = argv[++i];
+        else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) metrics.path = argv[++i];
+        else if (std::strcmp(argv[i], "--no-metrics") == 0) Metrics::global().setEnabled(false);
+        else if (std::strcmp(argv[i], "--search-cache") == 0 && i + 1 < argc && parseInt(argv[i + 1], cacheMb) &&
+                 cacheMb >= 0) i++;
+        else if (std::strcmp(argv[i], "--list") == 0 && i + 1 < argc &&
+                 (std::strcmp(argv[i + 1], "books") == 0 || std::strcmp(argv[i + 1], "users") == 0)) {
+            listWhat = argv[++i];
+            listing = true;
+        } else if (std::strcmp(argv[i], "--facets") == 0 && i + 1 < argc && parseFacet(argv[i + 1], facet)) {
+            listWhat = "facets";
+            listing = true;
+            i++;
+        } else if (std::strcmp(argv[i], "--browse") == 0 && i + 2 < argc && parseFacet(argv[i + 1], facet)) {
+            listWhat = "browse";
+            query = argv[i + 2];
+            listing = true;
+            i += 2;
+        } else if (std::strcmp(argv[i], "--overdue") == 0) {
+            listWhat = "overdue";
+            listing = true;
+        } else if (std::strcmp(argv[i], "--as-of") == 0 && i + 1 < argc && parseInt(argv[i + 1], asOf)) {
+            i++;
+        } else if (std::strcmp(argv[i], "--search") == 0 && i + 1 < argc) {
+            listWhat = "books";
+            query = argv[++i];
+            listing = true;
+        } else if (std::strcmp(argv[i], "--fuzzy") == 0 && i + 1 < argc) {
+            listWhat = "fuzzy";
+            query = argv[++i];
+            listing = true;
+        }
+        else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc && parseTableFormat(argv[i + 1], tableFormat)) i++;
+        else if (std::strcmp(argv[i], "--offset") == 0 && i + 1 < argc && parseInt(argv[i + 1], offset) && offset >= 0) i++;
+        else if (std::strcmp(argv[i], "--limit") == 0 && i + 1 < argc && parseInt(argv[i + 1], limit) && limit >= 0) i++;
+        else {
+            std::cout << "Usage: " << argv[0]
+                      << " [--binary [--export-text]] [--threads N] [--metrics FILE | --no-metrics]\n"
+                      << "       [--search-cache MB]\n"
+                      << "       [--serve SOCKET | --batch FILE | LISTING]\n"
+                      << "  --binary       load/save data/library.snap (imports the text files if it is missing)\n"
+                      << "  --export-text  with --binary, also write data/books.txt and data/users.txt\n"
+                      << "  --threads N    parse the text files on N threads, 1 to 1024 (default: one per core)\n"
+                      << "  --serve SOCKET serve concurrent sessions on a Unix socket until stdin closes\n"
+                      << "  --batch FILE   apply a CSV/TSV file of add/borrow/return rows, all or nothing\n"
+                      << "  --metrics FILE write operation latencies and counters to FILE (Prometheus text)\n"
+                      << "                 on exit, and in --serve mode whenever 'metrics' is entered\n"
+                      << "  --no-metrics   do not time operations\n"
+                      << "  --search-cache MB  memory for repeated search results (default 8, 0 = off)\n"
+                      << "LISTING prints a table and exits:\n"
+                      << "  --list books|users | --search QUERY | --fuzzy QUERY (top 10 unless --limit)\n"
+                      << "  | --overdue [--as-of UNIX_TIME]\n"
+                      << "  | --facets genre|author | --browse genre|author VALUE\n"
+                      << "  [--format text|tsv|json] [--offset N] [--limit N]\n";
+            return 1;
+        }
+    }
+
+    unsigned threads = static_cast<unsigned>(threadCount);
+
+    if (!serveSocket.empty()) {
+        LibrarySystem app(format, "data", threads);
+        app.setTextExport(exportText);
+        app.setSearchCacheCapacity(static_cast<size_t>(cacheMb) << 20);
+        LibraryServer server(app, serveSocket);
+        if (!server.start()) {
+            std::cerr << "[Error] Could not listen on " << serveSocket << "\n";
+            return 1;
+        }
+        std::cout << "Serving on " << serveSocket << ". Enter 'metrics' for a latency dump, or 'quit' to stop.\n";
+        std::string line;
+        // Runs until end of input or 'quit'; a typo must not stop the server
+        while (std::getline(std::cin, line) && line != "quit") {
+            if (line.empty()) continue;
+            if (line != "metrics") {
+                std::cerr << "[Error] Unknown command '" << line << "'. Enter 'metrics' or 'quit'.\n";
+                continue;
+            }
+            std::cout << Metrics::global().text();
+            if (!metrics.write()) std::cerr << "[Error] Could not write " << metrics.path << "\n";
+        }
+        server.stop();
+        return 0;
+    }
+
+    if (!batchFile.empty()) return runBatch(batchFile, format, exportText, threads);
+
+    if (listing) {
+        LibrarySystem app(format, "data", threads, AccessMode::ReadOnly);
+        LibraryConsole console(app);
+        size_t rows = limit < 0 ? SIZE_MAX : static_cast<size_t>(limit);
+        if (listWhat == "users") console.printUsers(tableFormat, offset, rows);
+        else if (listWhat == "facets") console.printFacets(facet, tableFormat, offset, rows);
+        else if (listWhat == "fuzzy") console.printFuzzy(query, tableFormat, limit < 0 ? 10 : rows);
+        else if (listWhat == "browse") console.printBrowse(facet, query, tableFormat, offset, rows);
+        else if (listWhat == "overdue") console.printOverdue(static_cast<time_t>(asOf), tableFormat);
+        else console.printBooks(query, tableFormat, offset, rows);
+        return 0;
+    }
 
-int main() {
 	std::system("clear");
-    LibrarySystem app;
-    
-    while (app.run());
+    LibrarySystem app(format, "data", threads);
+    app.setTextExport(exportText);
+    app.setSearchCacheCapacity(static_cast<size_t>(cacheMb) << 20);
+    LibraryConsole console(app);
+
+    while (console.run());
 
     std::cout << "Program Terminated. Goodbye!\n";
     return 0;
@@ -0,0 +1,84 @@
+#include "Batch.hpp"
+#include "TextScanner.hpp"
+#include <cctype>
+
+// Splits one CSV/TSV row; quoted fields may hold the delimiter and "" for a quote
+static void splitRow(std::string_view line, char delim, std::vector<std::string>& fields) {
+    fields.clear();
+    size_t i = 0;
+    while (true) {
+        std::string field;
+        if (i < line.size() && line[i] == '"') {
+            for (i++; i < line.size(); i++) {
+                if (line[i] != '"') field += line[i];
+                else if (i + 1 < line.size() && line[i + 1] == '"') field += line[++i];
+                else {
+                    i++;
+                    break;
+                }
+            }
+            // Anything between the closing quote and the delimiter is kept
+            while (i < line.size() && line[i] != delim) field += line[i++];
+        } else {
+            const char* end = findByte(line.data() + i, line.data() + line.size(), delim);
+            field.assign(line.data() + i, end);
+            i = end - line.data();
+        }
+        fields.push_back(std::move(field));
+        if (i >= line.size()) return;
+        i++; // the delimiter
+    }
+}
+
+static bool sameWord(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++)
+        if (std::tolower(static_cast<unsigned char>(a[i])) != b[i]) return false;
+    return true;
+}
+
+void parseBatch(std::string_view text, char delim, std::vector<BatchOp>& ops, std::vector<BatchError>& errors) {
+    LineReader lines(text);
+    std::string_view line;
+    std::vector<std::string> f;
+    size_t lineNo = 0;
+    while (lines.next(line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty() || line[0] == '#') continue;
+        splitRow(line, delim, f);
+
+        BatchOp op;
+        op.line = lineNo;
+        if (sameWord(f[0], "add") && f.size() == 5) {
+            op.kind = BatchOpKind::AddBook;
+            op.bookId = f[1];
+            op.title = f[2];
+            op.author = f[3];
+            op.genre = f[4];
+        } else if (sameWord(f[0], "borrow") && f.size() == 3) {
+            op.kind = BatchOpKind::Borrow;
+            op.memberId = f[1];
+            op.bookId = f[2];
+        } else if (sameWord(f[0], "return") && (f.size() == 2 || f.size() == 3)) {
+            op.kind = BatchOpKind::Return;
+            op.bookId = f[1];
+            if (f.size() == 3) op.memberId = f[2];
+        } else {
+            errors.push_back(BatchError{lineNo, "unrecognised row (expected add/borrow/return with the right number of fields)"});
+            continue;
+        }
+        ops.push_back(std::move(op));
+    }
+}
+
+bool readBatchFile(const std::string& path, std::vector<BatchOp>& ops, std::vector<BatchError>& errors) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    std::string_view text = file.view();
+    bool tsv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".tsv") == 0;
+    std::string_view first = text.substr(0, text.find('\n'));
+    if (first.find('\t') != std::string_view::npos) tsv = true;
+    parseBatch(text, tsv ? '\t' : ',', ops, errors);
+    return true;
+}
@@ -1,24 +1,36 @@
 #include "Book.hpp"
+#include "TextScanner.hpp"
 #include <string>
 #include <sstream>
 #include <iomanip>
 #include <ctime>
 
-Book::Book(std::string id, std::string title, std::string author, std::string genre, time_t dueDate)
-    : id(id), title(title), author(author), genre(genre), isBorrowed(false), dueDate(dueDate), borrowedByMemberId("") {}
+Book::Book(std::string_view id, std::string_view title, std::string_view author, std::string_view genre, time_t dueDate)
+    : id(StringPool::global().intern(id)), title(StringPool::global().intern(title)),
+      author(StringPool::global().intern(author)), genre(StringPool::global().intern(genre)),
+      borrowedByMemberId(0), isBorrowed(false), dueDate(dueDate) {}
 
-std::string Book::getId() const { return id; }
-std::string Book::getTitle() const { return title; }
-std::string Book::getAuthor() const { return author; }
-std::string Book::getGenre() const { return genre; }
+Book::Book(const BookRecord& record)
+    : id(record.id), title(record.title), author(record.author), genre(record.genre),
+      borrowedByMemberId(record.borrowedBy), isBorrowed(record.isBorrowed), dueDate(record.dueDate) {}
+
+std::string_view Book::getId() const { return StringPool::global().view(id); }
+std::string_view Book::getTitle() const { return StringPool::global().view(title); }
+std::string_view Book::getAuthor() const { return StringPool::global().view(author); }
+std::string_view Book::getGenre() const { return StringPool::global().view(genre); }
 bool Book::getIsBorrowed() const { return isBorrowed; }
 time_t Book::getDueDate() const { return dueDate; }
-std::string Book::getBorrowedById() const { return borrowedByMemberId; }
+std::string_view Book::getBorrowedById() const { return StringPool::global().view(borrowedByMemberId); }
+const ReservationQueue& Book::getReservations() const { return reservationQueue; }
+
+BookRecord Book::record() const {
+    return BookRecord{id, title, author, genre, borrowedByMemberId, isBorrowed, dueDate};
+}
 
 #include <iostream>
-void Book::borrowBook(std::string memberId, int daysToBorrow, time_t due) {
+void Book::borrowBook(std::string_view memberId, int daysToBorrow, time_t due) {
     isBorrowed = true;
-    borrowedByMemberId = memberId;
+    borrowedByMemberId = StringPool::global().intern(memberId);
     // Set due date to current time + days
 	if (due)
 		dueDate = due;
@@ -28,28 +40,31 @@ void Book::borrowBook(std::string memberId, int daysToBorrow, time_t due) {
 
 void Book::returnBook() {
     isBorrowed = false;
-    borrowedByMemberId = "";
+    borrowedByMemberId = 0;
     dueDate = 0;
 }
 
-void Book::addReservation(std::string memberId) {
+void Book::addReservation(std::string_view memberId) {
     reservationQueue.push(memberId);
 }
 
 std::string Book::processNextReservation() {
-    if (reservationQueue.empty()) return "";
-    std::string nextMember = reservationQueue.front();
-    reservationQueue.pop();
+    std::string nextMember;
+    reservationQueue.pop(nextMember);
     return nextMember;
 }
 
+bool Book::removeReservation(std::string_view memberId) {
+    return reservationQueue.remove(memberId);
+}
+
 bool Book::hasReservations() const {
     return !reservationQueue.empty();
 }
 
 std::string Book::toString() const {
     std::stringstream ss;
-    ss << "ID: " << id << " | Title: " << title << " | Author: " << author 
+    ss << "ID: " << getId() << " | Title: " << getTitle() << " | Author: " << getAuthor()
        << " | Status: " << (isBorrowed ? "Borrowed" : "Available");
     
     if (isBorrowed) {
@@ -67,23 +82,23 @@ std::string Book::toString() const {
 
 std::string Book::toFileString() const {
     std::stringstream ss;
-    ss << id << "|" << title << "|" << author << "|" << genre << "|" 
-       << isBorrowed << "|" << dueDate << "|" << borrowedByMemberId << "|";
+    ss << getId() << "|" << getTitle() << "|" << getAuthor() << "|" << getGenre() << "|"
+       << isBorrowed << "|" << dueDate << "|" << getBorrowedById() << "|";
     
     // Save queue data
-    std::queue<std::string> tempQ = reservationQueue;
-    while(!tempQ.empty()) {
-        ss << tempQ.front();
-        tempQ.pop();
-        if(!tempQ.empty()) ss << ",";
+    bool first = true;
+    for (std::string_view memberId : reservationQueue) {
+        if (!first) ss << ",";
+        ss << memberId;
+        first = false;
     }
     return ss.str();
 }
 
-void Book::loadReservationsFromString(const std::string& data) {
-    std::stringstream ss(data);
-    std::string memberId;
-    while(std::getline(ss, memberId, ',')) {
-        if(!memberId.empty()) reservationQueue.push(memberId);
+void Book::loadReservationsFromString(std::string_view data) {
+    FieldSplitter ids(data, ',');
+    std::string_view memberId;
+    while (ids.next(memberId)) {
+        if (!memberId.empty()) reservationQueue.push(memberId);
     }
 }
\ No newline at end of file
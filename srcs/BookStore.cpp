@@ -0,0 +1,42 @@
+#include "BookStore.hpp"
+#include <utility>
+
+BookStore::BookStore() : count(0) {}
+
+BookHandle BookStore::add(Book book) {
+    BookHandle handle;
+    if (!freeSlots.empty()) {
+        handle = freeSlots.back();
+        freeSlots.pop_back();
+        records[handle] = std::move(book);
+        live[handle] = 1;
+    } else {
+        handle = static_cast<BookHandle>(records.size());
+        records.push_back(std::move(book));
+        live.push_back(1);
+    }
+    count++;
+    return handle;
+}
+
+void BookStore::remove(BookHandle handle) {
+    if (!isLive(handle)) return;
+    // Frees the reservation queue; the strings are interned and stay in the
+    // pool. The slot itself is recycled by add().
+    records[handle] = Book("", "", "", "", 0);
+    live[handle] = 0;
+    freeSlots.push_back(handle);
+    count--;
+}
+
+void BookStore::clear() {
+    records.clear();
+    live.clear();
+    freeSlots.clear();
+    count = 0;
+}
+
+void BookStore::reserve(size_t n) {
+    records.reserve(n);
+    live.reserve(n);
+}
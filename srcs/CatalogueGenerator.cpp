@@ -0,0 +1,191 @@
+#include "CatalogueGenerator.hpp"
+#include <algorithm>
+#include <fstream>
+
+static const char* const WORDS[] = {
+    "Shadow", "River", "Garden", "Empire", "Winter", "Silent", "Glass", "Harbour", "Storm", "Letters",
+    "Night", "Golden", "Forest", "Memory", "Island", "Crown", "Mountain", "Secret", "Stone", "Light",
+    "Iron", "Ocean", "Paper", "Summer", "Hidden", "Broken", "Clock", "Desert", "Fire", "Lantern",
+    "Mirror", "Northern", "Orchard", "Painted", "Quiet", "Road", "Salt", "Thread", "Velvet", "Wild",
+    "Atlas", "Bridge", "City", "Daughter", "Engine", "Field", "Ghost", "House", "Journey", "Kingdom",
+    "Library", "Machine", "Names", "Orbit", "Prince", "Queen", "Rain", "Signal", "Tide", "Voyage",
+};
+static const char* const FIRST_NAMES[] = {
+    "Aisha", "Ben", "Chen", "Diana", "Elif", "Farid", "Grace", "Hiro", "Ines", "Jonas",
+    "Kavya", "Liam", "Mei", "Nadia", "Omar", "Priya", "Quentin", "Rosa", "Sven", "Tariq",
+};
+static const char* const SURNAMES[] = {
+    "Abbott", "Bakar", "Castillo", "Dubois", "Eriksen", "Fujita", "Gupta", "Hassan", "Ivanova", "Jensen",
+    "Kowalski", "Lim", "Moreau", "Nakamura", "Okafor", "Petrov", "Rahman", "Silva", "Tan", "Wong",
+};
+static const char* const GENRES[] = {
+    "Fiction", "Fantasy", "Mystery", "Science Fiction", "History", "Biography", "Romance", "Poetry",
+    "Thriller", "Children", "Science", "Travel",
+};
+
+template <typename T, size_t N>
+static size_t countOf(T (&)[N]) {
+    return N;
+}
+
+// splitmix64: fixed output for a given seed on every platform
+struct Random {
+    uint64_t state;
+    explicit Random(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    size_t below(size_t n) { return n ? next() % n : 0; }
+    bool chance(double p) { return (next() >> 11) * (1.0 / 9007199254740992.0) < p; }
+};
+
+// Per-book attributes come from their own stream, so a book's title is the
+// same wherever it is referenced (the catalogue and member histories)
+static std::string titleOf(uint64_t seed, size_t book) {
+    Random r(seed * 0x100000001B3ull + book);
+    std::string title = "The ";
+    size_t words = 2 + r.below(3);
+    for (size_t w = 0; w < words; w++) {
+        if (w) title += ' ';
+        title += WORDS[r.below(countOf(WORDS))];
+    }
+    if (r.chance(0.3)) title += " " + std::to_string(1 + r.below(9));
+    return title;
+}
+
+static std::string authorOf(uint64_t seed, size_t book) {
+    Random r(seed * 0xC2B2AE3D27D4EB4Full + book);
+    std::string author = FIRST_NAMES[r.below(countOf(FIRST_NAMES))];
+    author += ' ';
+    author += SURNAMES[r.below(countOf(SURNAMES))];
+    // A few co-authored books, for the author facet
+    if (r.chance(0.05)) {
+        author += "; ";
+        author += SURNAMES[r.below(countOf(SURNAMES))];
+    }
+    return author;
+}
+
+static std::string genreOf(Random& r) {
+    std::string genre = GENRES[r.below(countOf(GENRES))];
+    if (r.chance(0.15)) {
+        genre += ", ";
+        genre += GENRES[r.below(countOf(GENRES))];
+    }
+    return genre;
+}
+
+// Buffered so a million-row file is a few hundred writes
+class FileWriter {
+private:
+    std::ofstream out;
+    std::string buffer;
+
+public:
+    explicit FileWriter(const std::string& path) : out(path, std::ios::binary | std::ios::trunc) {}
+    std::string& line() { return buffer; }
+    void endLine() {
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20)) flush();
+    }
+    void flush() {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    bool close() {
+        flush();
+        out.close();
+        return !out.fail();
+    }
+};
+
+bool generateCatalogue(const std::string& dir, const CatalogueSpec& spec) {
+    const long long DAY = 24 * 60 * 60;
+    Random r(spec.seed);
+
+    FileWriter books(dir + "/books.txt");
+    for (size_t i = 1; i <= spec.books; i++) {
+        std::string& out = books.line();
+        out += std::to_string(i);
+        out += '|';
+        out += titleOf(spec.seed, i);
+        out += '|';
+        out += authorOf(spec.seed, i);
+        out += '|';
+        out += genreOf(r);
+        bool borrowed = spec.members > 0 && r.chance(spec.borrowedShare);
+        if (!borrowed) {
+            out += "|0|0||";
+            books.endLine();
+            continue;
+        }
+        size_t borrower = 1 + r.below(spec.members);
+        out += "|1|" + std::to_string(spec.epoch + (static_cast<long long>(r.below(29)) - 14) * DAY);
+        out += '|' + std::to_string(borrower) + '|';
+        if (r.chance(spec.reservedShare)) {
+            // Distinct members other than the borrower, in queue order
+            size_t depth = std::min(spec.reservations, spec.members - 1);
+            size_t first = r.below(spec.members);
+            for (size_t k = 0, m = first; k < depth; m++) {
+                size_t member = 1 + m % spec.members;
+                if (member == borrower) continue;
+                if (k++) out += ',';
+                out += std::to_string(member);
+            }
+        }
+        books.endLine();
+    }
+
+    FileWriter users(dir + "/users.txt");
+    users.line() += "Librarian|admin|Admin|admin@library.com";
+    users.endLine();
+    users.line() += "Librarian|L1|Head Librarian|head@library.com";
+    users.endLine();
+    for (size_t i = 1; i <= spec.members; i++) {
+        std::string& out = users.line();
+        std::string id = std::to_string(i);
+        out += "Member|" + id + "|Member " + id + "|m" + id + "@mail.com|";
+        // Borrow and return pairs, one entry a day, ending at the epoch
+        long long time = spec.epoch - static_cast<long long>(spec.history) * DAY;
+        size_t book = 1;
+        for (size_t h = 0; h < spec.history && spec.books > 0; h++, time += DAY) {
+            if (h % 2 == 0) book = 1 + r.below(spec.books);
+            if (h) out += ',';
+            out += std::to_string(time);
+            out += h % 2 == 0 ? "|Borrowed|" : "|Returned|";
+            out += titleOf(spec.seed, book);
+        }
+        users.endLine();
+    }
+    bool ok = books.close();
+    return users.close() && ok;
+}
+
+std::vector<std::string> sampleQueries(const CatalogueSpec& spec, size_t n) {
+    Random r(spec.seed ^ 0x5EA4C4ull);
+    std::vector<std::string> queries;
+    queries.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        // One draw per statement: the order of calls within an expression is unspecified
+        std::string query;
+        switch (i % 5) {
+            case 0: query = WORDS[r.below(countOf(WORDS))]; break;
+            case 1: query = SURNAMES[r.below(countOf(SURNAMES))]; break;
+            case 2: query = GENRES[r.below(countOf(GENRES))]; break;
+            case 3:
+                query = WORDS[r.below(countOf(WORDS))];
+                query += ' ';
+                query += WORDS[r.below(countOf(WORDS))];
+                break;
+            default:
+                query = FIRST_NAMES[r.below(countOf(FIRST_NAMES))];
+                query += ' ';
+                query += SURNAMES[r.below(countOf(SURNAMES))];
+        }
+        queries.push_back(query);
+    }
+    return queries;
+}
@@ -0,0 +1,59 @@
+#include "CatalogueVersions.hpp"
+
+CatalogueVersions::CatalogueVersions() : userSlotCount(0) {
+    publish();
+}
+
+void CatalogueVersions::putBook(BookHandle handle, const Book& book) {
+    books.set(handle, book.record());
+}
+
+void CatalogueVersions::eraseBook(BookHandle handle) {
+    books.erase(handle);
+}
+
+void CatalogueVersions::putUser(const Person& user) {
+    uint32_t slot;
+    if (const uint32_t* found = userSlots.find(user.getId())) {
+        slot = *found;
+    } else if (!freeUserSlots.empty()) {
+        slot = freeUserSlots.back();
+        freeUserSlots.pop_back();
+        userSlots.insert(user.getId(), slot);
+    } else {
+        slot = userSlotCount++;
+        userSlots.insert(user.getId(), slot);
+    }
+    StringPool& pool = StringPool::global();
+    users.set(slot, UserRecord{pool.intern(user.getId()), pool.intern(user.getName()), pool.intern(user.getEmail()),
+                               user.role()});
+}
+
+void CatalogueVersions::eraseUser(const std::string& id) {
+    const uint32_t* slot = userSlots.find(id);
+    if (!slot) return;
+    users.erase(*slot);
+    freeUserSlots.push_back(*slot);
+    userSlots.erase(id);
+}
+
+void CatalogueVersions::clear() {
+    books.clear();
+    users.clear();
+    userSlots.clear();
+    freeUserSlots.clear();
+    userSlotCount = 0;
+}
+
+void CatalogueVersions::publish() {
+    auto state = std::make_shared<CatalogueSnapshot::State>();
+    state->books = books.publish();
+    state->users = users.publish();
+    std::atomic_store(&published, std::shared_ptr<const CatalogueSnapshot::State>(std::move(state)));
+}
+
+CatalogueSnapshot CatalogueVersions::pin() const {
+    CatalogueSnapshot snapshot;
+    snapshot.state = std::atomic_load(&published);
+    return snapshot;
+}
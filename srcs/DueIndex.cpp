@@ -0,0 +1,81 @@
+#include "DueIndex.hpp"
+#include <algorithm>
+
+void DueIndex::place(size_t i, DueLoan loan) {
+    heap[i] = loan;
+    position[loan.book] = static_cast<uint32_t>(i);
+}
+
+void DueIndex::siftUp(size_t i) {
+    DueLoan loan = heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (heap[parent].due <= loan.due) break;
+        place(i, heap[parent]);
+        i = parent;
+    }
+    place(i, loan);
+}
+
+void DueIndex::siftDown(size_t i) {
+    DueLoan loan = heap[i];
+    size_t n = heap.size();
+    while (true) {
+        size_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && heap[child + 1].due < heap[child].due) child++;
+        if (loan.due <= heap[child].due) break;
+        place(i, heap[child]);
+        i = child;
+    }
+    place(i, loan);
+}
+
+void DueIndex::add(BookHandle book, time_t due) {
+    if (book >= position.size()) position.resize(book + 1, NOT_QUEUED);
+    uint32_t at = position[book];
+    if (at != NOT_QUEUED) {
+        time_t old = heap[at].due;
+        heap[at].due = due;
+        if (due < old) siftUp(at);
+        else siftDown(at);
+        return;
+    }
+    heap.push_back(DueLoan{due, book});
+    siftUp(heap.size() - 1);
+}
+
+void DueIndex::remove(BookHandle book) {
+    if (!contains(book)) return;
+    size_t at = position[book];
+    position[book] = NOT_QUEUED;
+    DueLoan last = heap.back();
+    heap.pop_back();
+    if (at == heap.size()) return;
+    // The moved entry may belong above or below the hole
+    place(at, last);
+    if (at > 0 && heap[(at - 1) / 2].due > last.due) siftUp(at);
+    else siftDown(at);
+}
+
+bool DueIndex::contains(BookHandle book) const {
+    return book < position.size() && position[book] != NOT_QUEUED;
+}
+
+std::vector<DueLoan> DueIndex::dueBefore(time_t asOf) const {
+    std::vector<DueLoan> found;
+    if (heap.empty() || heap[0].due >= asOf) return found;
+    // A subtree whose root is not due yet holds nothing that is
+    std::vector<size_t> pending(1, 0);
+    while (!pending.empty()) {
+        size_t i = pending.back();
+        pending.pop_back();
+        found.push_back(heap[i]);
+        for (size_t child = 2 * i + 1; child <= 2 * i + 2 && child < heap.size(); child++)
+            if (heap[child].due < asOf) pending.push_back(child);
+    }
+    std::sort(found.begin(), found.end(), [](const DueLoan& a, const DueLoan& b) {
+        return a.due != b.due ? a.due < b.due : a.book < b.book;
+    });
+    return found;
+}
@@ -0,0 +1,171 @@
+#include "FacetIndex.hpp"
+#include <algorithm>
+#include <cctype>
+
+FacetIndex::FacetIndex(const BookStore& store) : store(store), deadValues(0) {}
+
+std::string_view FacetIndex::text(const Book& book, Facet facet) {
+    return facet == Facet::Genre ? book.getGenre() : book.getAuthor();
+}
+
+void FacetIndex::normalize(std::string_view raw, std::string& out) {
+    out.clear();
+    bool space = false;
+    for (char c : raw) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (std::isspace(u)) {
+            space = !out.empty();
+            continue;
+        }
+        if (space) out += ' ';
+        space = false;
+        out += static_cast<char>(std::tolower(u));
+    }
+}
+
+void FacetIndex::collect(const Book& book, Facet facet) {
+    Field& f = field(facet);
+    bookIds.clear();
+    std::string_view all = text(book, facet);
+    char separator = facet == Facet::Author ? ';' : ',';
+    while (true) {
+        size_t comma = all.find(separator);
+        std::string_view raw = all.substr(0, comma);
+        normalize(raw, scratch);
+        if (!scratch.empty()) {
+            const uint32_t* found = f.ids.find(scratch);
+            uint32_t id;
+            if (found) {
+                id = *found;
+            } else {
+                size_t begin = raw.find_first_not_of(" \t\r\n");
+                size_t end = raw.find_last_not_of(" \t\r\n");
+                Value value{scratch, std::string(raw.substr(begin, end - begin + 1)), {}, 0};
+                if (f.freeIds.empty()) {
+                    id = static_cast<uint32_t>(f.values.size());
+                    f.values.push_back(std::move(value));
+                } else {
+                    id = f.freeIds.back();
+                    f.freeIds.pop_back();
+                    f.values[id] = std::move(value);
+                }
+                f.ids.insert(scratch, id);
+            }
+            // "Fiction, fiction" counts the book once
+            if (std::find(bookIds.begin(), bookIds.end(), id) == bookIds.end() && bookIds.size() < UINT8_MAX)
+                bookIds.push_back(id);
+        }
+        if (comma == std::string_view::npos) break;
+        all.remove_prefix(comma + 1);
+    }
+}
+
+template <typename F>
+void FacetIndex::forEachValue(BookHandle handle, F fn) {
+    if (handle >= byBook.size()) return;
+    const BookValues& bv = byBook[handle];
+    const uint32_t* ids = valuePool.data() + bv.first;
+    for (uint8_t i = 0; i < bv.genres; i++) fn(fields[0].values[ids[i]]);
+    for (uint8_t i = 0; i < bv.authors; i++) fn(fields[1].values[ids[bv.genres + i]]);
+}
+
+void FacetIndex::add(BookHandle handle) {
+    const Book& book = store.get(handle);
+    if (handle >= byBook.size()) byBook.resize(handle + 1, BookValues{0, 0, 0});
+    BookValues& bv = byBook[handle];
+    bv.first = static_cast<uint32_t>(valuePool.size());
+    for (Facet facet : {Facet::Genre, Facet::Author}) {
+        collect(book, facet);
+        valuePool.insert(valuePool.end(), bookIds.begin(), bookIds.end());
+        (facet == Facet::Genre ? bv.genres : bv.authors) = static_cast<uint8_t>(bookIds.size());
+    }
+    forEachValue(handle, [&](Value& v) {
+        // Loads add in handle order; only recycled slots land mid-list
+        if (v.books.empty() || v.books.back() < handle) v.books.push_back(handle);
+        else v.books.insert(std::lower_bound(v.books.begin(), v.books.end(), handle), handle);
+        if (!book.getIsBorrowed()) v.available++;
+    });
+}
+
+void FacetIndex::remove(BookHandle handle) {
+    if (handle >= byBook.size()) return;
+    bool available = !store.get(handle).getIsBorrowed();
+    BookValues& bv = byBook[handle];
+    for (uint8_t i = 0; i < bv.genres + bv.authors; i++) {
+        Field& f = fields[i < bv.genres ? 0 : 1];
+        uint32_t id = valuePool[bv.first + i];
+        Value& v = f.values[id];
+        auto it = std::lower_bound(v.books.begin(), v.books.end(), handle);
+        if (it == v.books.end() || *it != handle) continue;
+        v.books.erase(it);
+        if (available) v.available--;
+        if (v.books.empty()) {
+            // Gone from counts(), and the slot goes to the next new value
+            f.ids.erase(v.key);
+            v = Value{};
+            f.freeIds.push_back(id);
+        }
+    }
+    deadValues += bv.genres + bv.authors;
+    bv = BookValues{0, 0, 0};
+    if (deadValues > 1024 && deadValues > valuePool.size() / 2) compactPool();
+}
+
+void FacetIndex::compactPool() {
+    std::vector<uint32_t> pool;
+    pool.reserve(valuePool.size() - deadValues);
+    for (BookValues& bv : byBook) {
+        uint32_t first = static_cast<uint32_t>(pool.size());
+        pool.insert(pool.end(), valuePool.begin() + bv.first, valuePool.begin() + bv.first + bv.genres + bv.authors);
+        bv.first = first;
+    }
+    valuePool.swap(pool);
+    deadValues = 0;
+}
+
+void FacetIndex::setAvailable(BookHandle handle, bool available) {
+    forEachValue(handle, [&](Value& v) {
+        if (available) v.available++;
+        else v.available--;
+    });
+}
+
+void FacetIndex::clear() {
+    for (Field& f : fields) {
+        f.ids.clear();
+        f.values.clear();
+        f.freeIds.clear();
+    }
+    byBook.clear();
+    valuePool.clear();
+    deadValues = 0;
+}
+
+const std::vector<BookHandle>* FacetIndex::books(Facet facet, std::string_view value) const {
+    std::string key;
+    normalize(value, key);
+    const uint32_t* id = field(facet).ids.find(key);
+    if (!id) return nullptr;
+    const Value& v = field(facet).values[*id];
+    return v.books.empty() ? nullptr : &v.books;
+}
+
+bool FacetIndex::count(Facet facet, std::string_view value, FacetCount& out) const {
+    std::string key;
+    normalize(value, key);
+    const uint32_t* id = field(facet).ids.find(key);
+    if (!id) return false;
+    const Value& v = field(facet).values[*id];
+    out = FacetCount{v.label, v.books.size(), v.available};
+    return true;
+}
+
+std::vector<FacetCount> FacetIndex::counts(Facet facet) const {
+    std::vector<FacetCount> all;
+    for (const Value& v : field(facet).values)
+        if (!v.books.empty()) all.push_back(FacetCount{v.label, v.books.size(), v.available});
+    std::sort(all.begin(), all.end(), [](const FacetCount& a, const FacetCount& b) {
+        return a.books != b.books ? a.books > b.books : a.value < b.value;
+    });
+    return all;
+}
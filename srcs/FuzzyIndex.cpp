@@ -0,0 +1,252 @@
+#include "FuzzyIndex.hpp"
+#include <algorithm>
+#include <cctype>
+
+static bool isWordChar(unsigned char c) {
+    // Bytes >= 0x80 keep UTF-8 sequences inside a single word
+    return std::isalnum(c) || c >= 0x80;
+}
+
+// Appends the lower-case words of text. Numbers are left to the exact
+// search: a typo in "1984" is a different number.
+static void splitWords(std::string_view text, std::vector<std::string>& out) {
+    std::string current;
+    bool letters = false;
+    auto flush = [&]() {
+        if (letters && current.size() <= FuzzyIndex::MAX_WORD) out.push_back(current);
+        current.clear();
+        letters = false;
+    };
+    for (unsigned char c : text) {
+        if (isWordChar(c)) {
+            current += static_cast<char>(std::tolower(c));
+            if (!std::isdigit(c)) letters = true;
+        } else if (!current.empty()) {
+            flush();
+        }
+    }
+    flush();
+}
+
+// Distinct trigrams of "$word$"
+static void trigramsOf(std::string_view word, std::vector<uint32_t>& out) {
+    out.clear();
+    size_t n = word.size() + 2;
+    auto at = [&](size_t i) -> uint32_t {
+        return i == 0 || i == n - 1 ? '$' : static_cast<unsigned char>(word[i - 1]);
+    };
+    for (size_t i = 0; i + 3 <= n; i++) out.push_back(at(i) << 16 | at(i + 1) << 8 | at(i + 2));
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+// Reused by FuzzyIndex::search() on each thread; all zero between calls
+struct SearchScratch {
+    std::vector<float> termBest, total; // by book handle
+    std::vector<uint8_t> shared;        // by word ID
+};
+
+// Myers' bit-vector edit distance (Hyyrö's form for whole strings): bit i
+// of each vector is the vertical delta at pattern letter i, so a column of
+// the DP table costs a few 64-bit operations instead of one per letter
+struct Pattern {
+    uint64_t peq[256]; // letter -> positions in the pattern
+    size_t length;
+
+    explicit Pattern(std::string_view text) : peq(), length(text.size()) {
+        for (size_t i = 0; i < length; i++) peq[static_cast<unsigned char>(text[i])] |= uint64_t(1) << i;
+    }
+
+    int distance(std::string_view text, int limit) const {
+        size_t n = text.size();
+        if ((n > length ? n - length : length - n) > static_cast<size_t>(limit)) return limit + 1;
+        if (length == 0) return static_cast<int>(n);
+        uint64_t pv = ~uint64_t(0), mv = 0;
+        uint64_t last = uint64_t(1) << (length - 1);
+        int score = static_cast<int>(length);
+        for (size_t j = 0; j < n; j++) {
+            uint64_t eq = peq[static_cast<unsigned char>(text[j])];
+            uint64_t xv = eq | mv;
+            uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            if (ph & last) score++;
+            else if (mh & last) score--;
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            // Each remaining letter can lower the score by at most one
+            if (score - static_cast<int>(n - j - 1) > limit) return limit + 1;
+        }
+        return score <= limit ? score : limit + 1;
+    }
+};
+
+FuzzyIndex::FuzzyIndex(const BookStore& store) : store(store) {}
+
+void FuzzyIndex::collectWords(const Book& book, std::vector<std::string>& out) {
+    out.clear();
+    splitWords(book.getTitle(), out);
+    splitWords(book.getAuthor(), out);
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void FuzzyIndex::add(BookHandle handle) {
+    collectWords(store.get(handle), scratch);
+    std::vector<uint32_t> grams;
+    for (const std::string& text : scratch) {
+        const uint32_t* found = ids.find(text);
+        uint32_t id;
+        if (found) {
+            id = *found;
+        } else if (freeIds.empty()) {
+            id = static_cast<uint32_t>(words.size());
+            words.push_back(Word{text, {}});
+        } else {
+            id = freeIds.back();
+            freeIds.pop_back();
+            words[id].text = text;
+        }
+        if (!found) {
+            ids.insert(text, id);
+            trigramsOf(text, grams);
+            for (uint32_t gram : grams) trigrams[gram].push_back(id);
+        }
+        std::vector<BookHandle>& books = words[id].books;
+        // Loads add in handle order; only recycled slots land mid-list
+        if (books.empty() || books.back() < handle) books.push_back(handle);
+        else books.insert(std::lower_bound(books.begin(), books.end(), handle), handle);
+    }
+}
+
+void FuzzyIndex::remove(BookHandle handle) {
+    collectWords(store.get(handle), scratch);
+    std::vector<uint32_t> grams;
+    for (const std::string& text : scratch) {
+        const uint32_t* found = ids.find(text);
+        if (!found) continue;
+        uint32_t id = *found;
+        std::vector<BookHandle>& books = words[id].books;
+        auto it = std::lower_bound(books.begin(), books.end(), handle);
+        if (it != books.end() && *it == handle) books.erase(it);
+        if (!books.empty()) continue;
+
+        // Last book gone: drop the word from its trigram lists
+        trigramsOf(text, grams);
+        for (uint32_t gram : grams) {
+            auto list = trigrams.find(gram);
+            if (list == trigrams.end()) continue;
+            std::vector<uint32_t>& wordIds = list->second;
+            auto at = std::find(wordIds.begin(), wordIds.end(), id);
+            if (at != wordIds.end()) {
+                *at = wordIds.back();
+                wordIds.pop_back();
+            }
+            if (wordIds.empty()) trigrams.erase(list);
+        }
+        ids.erase(text);
+        words[id].text.clear();
+        words[id].text.shrink_to_fit();
+        freeIds.push_back(id);
+    }
+}
+
+void FuzzyIndex::clear() {
+    ids.clear();
+    words.clear();
+    freeIds.clear();
+    trigrams.clear();
+}
+
+size_t FuzzyIndex::wordCount() const {
+    return words.size() - freeIds.size();
+}
+
+int FuzzyIndex::maxEdits(size_t length) {
+    if (length <= 2) return 0;
+    return length <= 5 ? 1 : 2;
+}
+
+int FuzzyIndex::distance(std::string_view a, std::string_view b, int limit) {
+    return Pattern(a).distance(b, limit);
+}
+
+std::vector<FuzzyResult> FuzzyIndex::search(const std::string& query, size_t k) const {
+    std::vector<FuzzyResult> results;
+    std::vector<std::string> terms;
+    splitWords(query, terms);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    if (terms.empty() || k == 0) return results;
+
+    // Per book, the best similarity for each query word, summed. Dense by
+    // handle: a common word can match a large share of the catalogue. The
+    // buffers live on between calls and every entry a search sets is reset
+    // before it returns, so a query only pays for what it touches.
+    static thread_local SearchScratch buffers;
+    if (buffers.termBest.size() < store.slotCount()) {
+        buffers.termBest.resize(store.slotCount(), 0.0f);
+        buffers.total.resize(store.slotCount(), 0.0f);
+    }
+    if (buffers.shared.size() < words.size()) buffers.shared.resize(words.size(), 0);
+    std::vector<float>& termBest = buffers.termBest;
+    std::vector<float>& total = buffers.total;
+    std::vector<uint8_t>& shared = buffers.shared; // trigrams in common, by word
+    std::vector<BookHandle> termBooks, matched;
+    std::vector<uint32_t> touched, grams;
+    for (const std::string& term : terms) {
+        int limit = maxEdits(term.size());
+        Pattern pattern(term);
+        trigramsOf(term, grams);
+        for (uint32_t gram : grams) {
+            auto it = trigrams.find(gram);
+            if (it == trigrams.end()) continue;
+            for (uint32_t w : it->second) {
+                if (shared[w] == 0) touched.push_back(w);
+                if (shared[w] < UINT8_MAX) shared[w]++;
+            }
+        }
+        // An edit changes at most three trigrams, so a word within the budget
+        // keeps the rest; short words need at least one in common
+        size_t cut = 3 * static_cast<size_t>(limit);
+        size_t need = grams.size() > cut ? grams.size() - cut : 1;
+        for (uint32_t w : touched) {
+            size_t common = shared[w];
+            shared[w] = 0;
+            const Word& word = words[w];
+            if (common < need || word.books.empty()) continue;
+            int edits = pattern.distance(word.text, limit);
+            if (edits > limit) continue;
+            float similarity = 1.0f - static_cast<float>(edits) / std::max(term.size(), word.text.size());
+            for (BookHandle book : word.books) {
+                if (termBest[book] == 0.0f) termBooks.push_back(book);
+                termBest[book] = std::max(termBest[book], similarity);
+            }
+        }
+        touched.clear();
+        for (BookHandle book : termBooks) {
+            if (total[book] == 0.0f) matched.push_back(book);
+            total[book] += termBest[book];
+            termBest[book] = 0.0f;
+        }
+        termBooks.clear();
+    }
+    results.reserve(matched.size());
+    for (BookHandle book : matched) {
+        results.push_back(FuzzyResult{book, total[book] / terms.size()});
+        total[book] = 0.0f;
+    }
+
+    auto better = [](const FuzzyResult& a, const FuzzyResult& b) {
+        return a.score != b.score ? a.score > b.score : a.book < b.book;
+    };
+    if (results.size() > k) {
+        std::partial_sort(results.begin(), results.begin() + k, results.end(), better);
+        results.resize(k);
+    } else {
+        std::sort(results.begin(), results.end(), better);
+    }
+    return results;
+}
@@ -0,0 +1,81 @@
+#include "HistoryLog.hpp"
+#include "TextScanner.hpp"
+#include <algorithm>
+
+std::string_view historyActionName(HistoryAction action) {
+    return action == HistoryAction::Borrowed ? "Borrowed" : "Returned";
+}
+
+bool parseHistoryAction(std::string_view name, HistoryAction& action) {
+    if (name == "Borrowed") action = HistoryAction::Borrowed;
+    else if (name == "Returned") action = HistoryAction::Returned;
+    else return false;
+    return true;
+}
+
+void HistoryLog::append(time_t time, HistoryAction action, std::string_view title) {
+    StringPool::Handle handle = StringPool::global().intern(title);
+    if (times.empty() || time >= times.back()) {
+        times.push_back(time);
+        titles.push_back(handle);
+        actions.push_back(action);
+        return;
+    }
+    size_t i = std::upper_bound(times.begin(), times.end(), static_cast<int64_t>(time)) - times.begin();
+    times.insert(times.begin() + i, time);
+    titles.insert(titles.begin() + i, handle);
+    actions.insert(actions.begin() + i, action);
+}
+
+bool HistoryLog::appendEntry(std::string_view entry) {
+    std::string_view parts[3];
+    long long time;
+    HistoryAction action;
+    // The title is everything after the second '|'
+    FieldSplitter fields(entry, '|');
+    if (!fields.next(parts[0]) || !fields.next(parts[1]) || !parseInt(parts[0], time) ||
+        !parseHistoryAction(parts[1], action)) {
+        unparsed.push_back(StringPool::global().intern(entry));
+        return false;
+    }
+    parts[2] = fields.rest();
+    append(static_cast<time_t>(time), action, parts[2]);
+    return true;
+}
+
+void HistoryLog::clear() {
+    times.clear();
+    titles.clear();
+    actions.clear();
+    unparsed.clear();
+}
+
+HistoryEntry HistoryLog::at(size_t i) const {
+    return HistoryEntry{static_cast<time_t>(times[i]), actions[i], StringPool::global().view(titles[i])};
+}
+
+HistoryLog::View HistoryLog::range(time_t from, time_t to) const {
+    size_t first = std::lower_bound(times.begin(), times.end(), static_cast<int64_t>(from)) - times.begin();
+    size_t last = std::lower_bound(times.begin(), times.end(), static_cast<int64_t>(to)) - times.begin();
+    return View(this, first, std::max(first, last));
+}
+
+HistoryLog::View HistoryLog::View::page(size_t offset, size_t count) const {
+    size_t begin = std::min(first + offset, last);
+    return View(log, begin, begin + std::min(count, last - begin));
+}
+
+void HistoryLog::writeTo(std::string& out) const {
+    for (size_t i = 0; i < size(); i++) {
+        if (i) out += ',';
+        out += std::to_string(times[i]);
+        out += '|';
+        out += historyActionName(actions[i]);
+        out += '|';
+        out += StringPool::global().view(titles[i]);
+    }
+    for (size_t i = 0; i < unparsed.size(); i++) {
+        if (i || size()) out += ',';
+        out += StringPool::global().view(unparsed[i]);
+    }
+}
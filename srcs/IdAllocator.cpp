@@ -0,0 +1,74 @@
+#include "IdAllocator.hpp"
+#include <algorithm>
+
+// Canonical decimal IDs within the tracked range
+static bool trackedId(std::string_view id, uint64_t& n) {
+    if (id.empty() || id.size() > 8 || id[0] == '0') return false;
+    n = 0;
+    for (char c : id) {
+        if (c < '0' || c > '9') return false;
+        n = n * 10 + (c - '0');
+    }
+    return n <= IdAllocator::MAX_TRACKED;
+}
+
+IdAllocator::IdAllocator() {
+    clear();
+}
+
+void IdAllocator::clear() {
+    used.assign(1, 1); // IDs start at 1
+    full.assign(1, 0);
+    lowest = 0;
+    overflow = MAX_TRACKED + 1;
+}
+
+void IdAllocator::grow(size_t words) {
+    if (words <= used.size()) return;
+    used.resize(words, 0);
+    full.resize((words + 63) / 64, 0);
+}
+
+void IdAllocator::set(uint64_t n) {
+    size_t w = n / 64;
+    used[w] |= uint64_t(1) << (n % 64);
+    if (used[w] == ~uint64_t(0)) full[w / 64] |= uint64_t(1) << (w % 64);
+}
+
+void IdAllocator::take(std::string_view id) {
+    uint64_t n;
+    if (!trackedId(id, n)) return;
+    grow(n / 64 + 1);
+    set(n);
+}
+
+void IdAllocator::release(std::string_view id) {
+    uint64_t n;
+    if (!trackedId(id, n) || n / 64 >= used.size()) return;
+    size_t w = n / 64;
+    used[w] &= ~(uint64_t(1) << (n % 64));
+    full[w / 64] &= ~(uint64_t(1) << (w % 64));
+    lowest = std::min(lowest, w);
+}
+
+uint64_t IdAllocator::allocate() {
+    // First word at or after lowest that is not full; words past the end
+    // have no full bit, so this stops at used.size() at the latest
+    size_t w = lowest;
+    while (w < used.size()) {
+        uint64_t open = ~full[w / 64] & (~uint64_t(0) << (w % 64));
+        if (open) {
+            w = w / 64 * 64 + __builtin_ctzll(open);
+            break;
+        }
+        w = (w / 64 + 1) * 64;
+    }
+    lowest = w;
+    if (w >= used.size()) {
+        if (uint64_t(w) * 64 > MAX_TRACKED) return overflow++;
+        grow(w + 1);
+    }
+    uint64_t n = uint64_t(w) * 64 + __builtin_ctzll(~used[w]);
+    set(n);
+    return n;
+}
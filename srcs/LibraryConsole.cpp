@@ -0,0 +1,570 @@
+#include "LibraryConsole.hpp"
+#include "Metrics.hpp"
+#include <iostream>
+#include <limits>
+#include <ctime>
+#include <cstdlib>
+#include <cstdio>
+
+/* HELPERS */
+static int getValidInt() {
+    int choice;
+    while (true) {
+        std::cin >> choice;
+        if (std::cin.fail()) {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "Invalid input. Please enter a number: ";
+        } else {
+            return choice;
+        }
+    }
+}
+
+static void printTitle() {
+    std::cout << "=======================================\n";
+    std::cout << "   SMART LIBRARY MANAGEMENT SYSTEM     \n";
+    std::cout << "=======================================\n";
+}
+
+// Clears the terminal and shows the banner
+static void newScreen() {
+    std::system("clear");
+    printTitle();
+}
+
+/* TABLES */
+// Columns of the search and loan listings
+static TableWriter bookTable() {
+    return TableWriter(std::cout, TableFormat::Text,
+                       {{"ID", 8}, {"Title", 30}, {"Author", 20}, {"Genre", 15}, {"Status", 10}, {"Due Date", 0}}, 110);
+}
+
+static void bookRow(TableWriter& table, const Book& b) {
+    table.cell(b.getId());
+    table.cell(b.getTitle());
+    table.cell(b.getAuthor());
+    table.cell(b.getGenre());
+    table.cell(b.getIsBorrowed() ? "Borrowed" : "Available");
+    if (b.getIsBorrowed()) table.dateCell(b.getDueDate());
+    else table.cell("-");
+    table.endRow();
+}
+
+LibraryConsole::LibraryConsole(LibrarySystem& library) : library(library) {}
+
+/* Listings */
+// Every column of a book, for the non-interactive listings
+static void writeBookList(const std::vector<Book>& list, TableFormat format) {
+    TableWriter table(std::cout, format,
+                      {{"ID", 8, "id"}, {"Title", 30, "title"}, {"Author", 20, "author"}, {"Genre", 15, "genre"},
+                       {"Status", 10, "status"}, {"Due Date", 12, "due"}, {"Borrower ID", 0, "borrower"}},
+                      125);
+    const char* none = format == TableFormat::Text ? "-" : "";
+    for (const Book& b : list) {
+        table.cell(b.getId());
+        table.cell(b.getTitle());
+        table.cell(b.getAuthor());
+        table.cell(b.getGenre());
+        table.cell(b.getIsBorrowed() ? "Borrowed" : "Available");
+        if (b.getIsBorrowed()) {
+            table.dateCell(b.getDueDate());
+            table.cell(b.getBorrowedById());
+        } else {
+            table.cell(none);
+            table.cell(none);
+        }
+        table.endRow();
+    }
+}
+
+void LibraryConsole::printBooks(const std::string& query, TableFormat format, size_t offset, size_t limit) {
+    writeBookList(library.search(query, offset, limit), format);
+}
+
+void LibraryConsole::printFuzzy(const std::string& query, TableFormat format, size_t limit) {
+    TableWriter table(std::cout, format,
+                      {{"Score", 6, "score"}, {"ID", 8, "id"}, {"Title", 30, "title"}, {"Author", 20, "author"},
+                       {"Genre", 15, "genre"}, {"Status", 0, "status"}},
+                      100);
+    for (const FuzzyMatch& match : library.fuzzySearch(query, limit)) {
+        table.cell(match.score, 2);
+        table.cell(match.book.getId());
+        table.cell(match.book.getTitle());
+        table.cell(match.book.getAuthor());
+        table.cell(match.book.getGenre());
+        table.cell(match.book.getIsBorrowed() ? "Borrowed" : "Available");
+        table.endRow();
+    }
+}
+
+void LibraryConsole::printBrowse(Facet facet, const std::string& value, TableFormat format, size_t offset,
+                                 size_t limit) {
+    writeBookList(library.browse(facet, value, offset, limit), format);
+}
+
+void LibraryConsole::printFacets(Facet facet, TableFormat format, size_t offset, size_t limit) {
+    std::vector<FacetCount> all = library.facetCounts(facet);
+    TableWriter table(std::cout, format,
+                      {{facet == Facet::Genre ? "Genre" : "Author", 30, "value"}, {"Books", 8, "books"},
+                       {"Available", 0, "available"}},
+                      55);
+    for (size_t i = offset; i < all.size() && i - offset < limit; i++) {
+        table.cell(all[i].value);
+        table.cell(static_cast<long long>(all[i].books));
+        table.cell(static_cast<long long>(all[i].available));
+        table.endRow();
+    }
+}
+
+void LibraryConsole::printUsers(TableFormat format, size_t offset, size_t limit) {
+    TableWriter table(std::cout, format, {{"ID", 10, "id"}, {"Name", 30, "name"}, {"Email", 30, "email"}, {"Role", 0, "role"}},
+                      90);
+    for (const UserInfo& user : library.listUsers(offset, limit)) {
+        table.cell(user.id);
+        table.cell(user.name);
+        table.cell(user.email);
+        table.cell(roleName(user.role));
+        table.endRow();
+    }
+}
+
+void LibraryConsole::printOverdue(time_t asOf, TableFormat format) {
+    OverdueReport report = library.overdueReport(asOf);
+    {
+        TableWriter table(std::cout, format,
+                          {{"Book ID", 8, "book"}, {"Title", 30, "title"}, {"Member ID", 10, "member"},
+                           {"Due Date", 12, "due"}, {"Days", 5, "days_overdue"}, {"Fine (RM)", 0, "fine"}},
+                          90);
+        for (const OverdueLoan& loan : report.loans) {
+            table.cell(loan.bookId);
+            table.cell(loan.title);
+            table.cell(loan.memberId);
+            table.dateCell(loan.dueDate);
+            table.cell(static_cast<long long>(loan.fine.daysOverdue));
+            table.cell(loan.fine.amount, 2);
+            table.endRow();
+        }
+    }
+    if (format != TableFormat::Text) return;
+    char date[32];
+    struct tm* timeInfo = localtime(&asOf);
+    if (!timeInfo || !strftime(date, sizeof(date), "%b %d %Y %H:%M", timeInfo)) std::snprintf(date, sizeof(date), "Unknown");
+    std::printf("%zu overdue loans, RM%.2f in fines as of %s\n\n", report.loans.size(), report.totalFines, date);
+}
+
+/* Menus */
+bool LibraryConsole::run() {
+    printTitle();
+    std::cout << "Login as: \n";
+    std::cout << "1. Librarian\n";
+    std::cout << "2. Member\n";
+    std::cout << "3. Guest (Seach only)\n";
+    std::cout << "0. Exit Program\n";
+    std::cout << "---------------------------------------\n";
+    std::cout << "Choice: ";
+
+    int choice = getValidInt();
+
+    if (choice == 0) return false;
+
+    if (choice == 3) {
+        guestMenu();
+        return true;
+    }
+
+    if (choice != 1 && choice != 2) {
+        std::cout << "Invalid choice.\n\n";
+        return true;
+    }
+
+    std::cout << "Logging in as: " << ((choice == 1) ? "Librarian\n" : "Member\n");
+    std::string id;
+    std::cout << "Enter User ID: ";
+    std::cin >> id;
+
+    UserInfo user;
+    if (!library.findUserInfo(id, user)) {
+        std::cout << "[Error] Invalid ID. (Hint: Try 'admin' if first run)\n\n";
+        return true;
+    }
+
+    if (choice == 1 && user.role == Role::Librarian)
+        librarianMenu(user);
+    else if (choice == 2 && user.role == Role::Member)
+        memberMenu(user);
+    else
+        std::cout << "[Error] Access Denied or Wrong Role.\n\n";
+    return true;
+}
+
+void LibraryConsole::librarianMenu(const UserInfo& lib) {
+    newScreen();
+    int choice;
+    do {
+        std::cout << "--- Librarian Menu (" << lib.name << ") ---\n";
+        std::cout << "1. Add Book\t\t4. Add User\t\t0. Logout\n";
+        std::cout << "2. Remove Book\t\t5. Remove User\t\t7. Overdue loans\n";
+        std::cout << "3. Display all books\t6. Display all users\t8. Performance metrics\nChoice: ";
+
+        choice = getValidInt();
+
+        switch (choice) {
+            case 1: addBook(); break;
+            case 2: removeBook(); break;
+            case 3: displayAllBooks(); break;
+            case 4: registerUser(); break;
+            case 5: removeUser(); break;
+            case 6: displayAllUsers(); break;
+            case 7: displayOverdue(); break;
+            case 8: displayMetrics(); break;
+            case 0: std::cout << "Logging out...\n\n"; break;
+            default: std::cout << "Invalid option.\n\n";
+        }
+    } while (choice != 0);
+}
+
+void LibraryConsole::memberMenu(const UserInfo& mem) {
+    newScreen();
+    int choice;
+    do {
+        std::cout << "--- Member Menu (" << mem.name << ") ---\n";
+        std::cout << "1. Search Books\n2. Borrow Book\n3. Return Book\n";
+        std::cout << "4. View Borrowed Books\n5. View History\n6. Browse by Genre\n0. Logout\nChoice: ";
+
+        choice = getValidInt();
+
+        switch (choice) {
+            case 1: searchBooks(); break;
+            case 2: borrowBook(mem); break;
+            case 3: returnBook(mem); break;
+            case 4: displayBorrowedBooks(mem); break;
+            case 5: displayHistory(mem); break;
+            case 6: browseGenres(); break;
+            case 0: std::cout << "Logging out...\n\n"; break;
+            default: std::cout << "Invalid option.\n\n";
+        }
+    } while (choice != 0);
+}
+
+void LibraryConsole::guestMenu() {
+    newScreen();
+    std::cout << "--- Guest Menu ---\n";
+    std::string input;
+
+    while(true) {
+        searchBooks();
+        std::cout << "Search for another book? (y/n): ";
+        std::cin >> input;
+        if (input != "y" && input != "Y")
+            break;
+    }
+
+    std::cout << "\nGuest access finished. Please register to borrow books.\n\n";
+}
+
+/* Librarian screens */
+void LibraryConsole::addBook() {
+    newScreen();
+    std::string title, author, genre;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    std::cout << "Enter Title: ";
+    std::getline(std::cin, title);
+    std::cout << "Enter Author: ";
+    std::getline(std::cin, author);
+    std::cout << "Enter Genre: ";
+    std::getline(std::cin, genre);
+
+    library.addBook(title, author, genre);
+    std::cout << "Book added successfully.\n";
+}
+
+void LibraryConsole::removeBook() {
+    newScreen();
+    displayAllBooks();
+
+    std::string id;
+    std::cout << "Enter Book ID to remove: ";
+    std::cin >> id;
+
+    if (library.removeBook(id) == OpStatus::Ok) std::cout << "Book removed.\n";
+    else std::cout << "Book not found.\n";
+}
+
+void LibraryConsole::displayAllBooks() {
+    newScreen();
+    std::cout << "--- Registered Books ---\n";
+    std::vector<Book> all = library.search("");
+    if (all.empty()) {
+        std::cout << "No books in library.\n";
+        return;
+    }
+
+    TableWriter table(std::cout, TableFormat::Text,
+                      {{"ID", 8}, {"Title", 30}, {"Author", 20}, {"Genre", 15}, {"Due Date", 15}, {"Borrower ID", 0}},
+                      115);
+    for (const Book& b : all) {
+        table.cell(b.getId());
+        table.cell(b.getTitle());
+        table.cell(b.getAuthor());
+        table.cell(b.getGenre());
+        table.dateCell(b.getDueDate());
+        table.cell(b.getBorrowedById().empty() ? "N/A" : b.getBorrowedById());
+        table.endRow();
+    }
+}
+
+void LibraryConsole::registerUser() {
+    newScreen();
+    std::cout << "Register New Account:\n1. Member\n2. Librarian\nChoice: ";
+    int type = getValidInt();
+
+    if (type != 1 && type != 2) {
+        std::cout << "Invalid account type selected.\n";
+        return;
+    }
+
+    std::string id, name, email;
+    std::cout << "Enter New ID: "; std::cin >> id;
+
+    UserInfo existing;
+    if (library.findUserInfo(id, existing)) {
+        std::cout << "[Error] User ID already exists!\n";
+        return;
+    }
+
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    std::cout << "Enter Name: "; std::getline(std::cin, name);
+    std::cout << "Enter Email: "; std::cin >> email;
+
+    Role role = type == 1 ? Role::Member : Role::Librarian;
+    if (library.registerUser(role, id, name, email) != OpStatus::Ok)
+        std::cout << "[Error] User ID already exists!\n";
+    else
+        std::cout << roleName(role) << " registered successfully.\n";
+}
+
+void LibraryConsole::removeUser() {
+    newScreen();
+    displayAllUsers();
+
+    std::string id;
+    std::cout << "Enter User ID to remove: "; std::cin >> id;
+
+    switch (library.removeUser(id)) {
+        case OpStatus::Ok: std::cout << "User removed.\n"; break;
+        case OpStatus::NotAllowed: std::cout << "[Error] Cannot remove the default admin account.\n"; break;
+        default: std::cout << "User not found.\n";
+    }
+}
+
+void LibraryConsole::displayAllUsers() {
+    newScreen();
+    std::cout << "--- Registered Users ---\n";
+    TableWriter table(std::cout, TableFormat::Text, {{"ID", 10}, {"Name", 30}, {"Email", 30}, {"Role", 0}}, 90);
+    for (const UserInfo& user : library.listUsers()) {
+        table.cell(user.id);
+        table.cell(user.name);
+        table.cell(user.email);
+        table.cell(roleName(user.role));
+        table.endRow();
+    }
+}
+
+void LibraryConsole::displayOverdue() {
+    newScreen();
+    std::cout << "--- Overdue Loans ---\n";
+    printOverdue(time(0), TableFormat::Text);
+}
+
+void LibraryConsole::displayMetrics() {
+    newScreen();
+    std::cout << "--- Performance Metrics (since startup) ---\n";
+    if (!Metrics::enabled()) std::cout << "Metrics are switched off.\n";
+    std::cout << Metrics::global().text();
+
+    SearchCacheStats cache = library.searchCacheStats();
+    uint64_t lookups = cache.hits + cache.misses;
+    printf("\nSearch cache: %zu entries, %.1f of %.1f MB, %.1f%% hits (%llu of %llu), %llu invalidated, "
+           "%llu evicted\n",
+           cache.entries, cache.bytes / 1048576.0, cache.capacity / 1048576.0,
+           lookups ? cache.hits * 100.0 / lookups : 0.0, static_cast<unsigned long long>(cache.hits),
+           static_cast<unsigned long long>(lookups), static_cast<unsigned long long>(cache.invalidations),
+           static_cast<unsigned long long>(cache.evictions));
+}
+
+/* Member screens */
+bool LibraryConsole::searchBooks() {
+    newScreen();
+    std::string query;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    std::cout << "Search (Title/Author/Genre): ";
+    std::getline(std::cin, query);
+
+    std::vector<Book> found = library.search(query);
+    if (found.empty()) {
+        std::vector<FuzzyMatch> close = library.fuzzySearch(query, 5);
+        if (close.empty()) {
+            std::cout << "No matching books found.\n";
+            return false;
+        }
+        // Still lets the member borrow one of the suggestions
+        std::cout << "No exact matches. Did you mean:\n";
+        TableWriter table = bookTable();
+        for (const FuzzyMatch& match : close) bookRow(table, match.book);
+        return true;
+    }
+
+    std::cout << "Search Results:\n";
+    TableWriter table = bookTable();
+    for (const Book& b : found) bookRow(table, b);
+    return true;
+}
+
+void LibraryConsole::browseGenres() {
+    newScreen();
+    std::cout << "--- Genres ---\n";
+    printFacets(Facet::Genre, TableFormat::Text, 0, SIZE_MAX);
+
+    std::string genre;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::cout << "Genre to list (or press Enter to go back): ";
+    std::getline(std::cin, genre);
+    if (genre.find_first_not_of(" \t") == std::string::npos) return;
+
+    std::vector<Book> found = library.browse(Facet::Genre, genre);
+    if (found.empty()) {
+        std::cout << "No books in that genre.\n";
+        return;
+    }
+    FacetCount count;
+    if (library.facetCount(Facet::Genre, genre, count))
+        std::cout << count.value << ": " << count.books << " books, " << count.available << " available\n";
+    TableWriter table = bookTable();
+    for (const Book& b : found) bookRow(table, b);
+}
+
+void LibraryConsole::borrowBook(const UserInfo& mem) {
+    newScreen();
+    std::cout << "\n--- Find a Book to Borrow ---\n";
+
+    if (!searchBooks()) return;
+
+    std::string bookId;
+    std::cout << "\n--- Enter Book ID ---\n";
+    std::cout << "Enter Book ID to borrow (or enter '0' to cancel): ";
+    std::cin >> bookId;
+
+    if (bookId == "0") {
+        std::cout << "Borrowing cancelled.\n";
+        return;
+    }
+
+    OpStatus status = library.borrow(mem.id, bookId);
+    if (status == OpStatus::NoSuchBook) {
+        std::cout << "[Error] Book does not exist.\n";
+    } else if (status == OpStatus::Unavailable) {
+        std::cout << "Book is currently unavailable.\n";
+        char ch;
+        std::cout << "Do you want to reserve it? (y/n): ";
+        std::cin >> ch;
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+        if ((ch == 'y' || ch == 'Y') && library.reserve(mem.id, bookId) == OpStatus::Ok)
+            std::cout << "You have been added to the reservation queue.\n";
+    } else if (status == OpStatus::Ok) {
+        std::cout << "Book borrowed successfully.\n";
+    }
+}
+
+void LibraryConsole::returnBook(const UserInfo& mem) {
+    newScreen();
+    std::cout << "\n--- Return a Book ---\n";
+
+    if (library.borrowedBy(mem.id).empty()) {
+        std::cout << "You currently have no borrowed books to return.\n";
+        return;
+    }
+    displayBorrowedBooks(mem);
+
+    std::string bookId;
+    std::cout << "Enter Book ID to return (or enter '0' to cancel): ";
+    std::cin >> bookId;
+
+    if (bookId == "0") {
+        std::cout << "Return cancelled.\n";
+        return;
+    }
+
+    ReturnResult result = library.returnBook(mem.id, bookId);
+    if (result.status == OpStatus::NoSuchBook) {
+        std::cout << "[Error] Invalid Book ID.\n";
+        return;
+    }
+    if (result.status != OpStatus::Ok) {
+        std::cout << "[Error] You did not borrow this book (ID: " << bookId << ").\n";
+        return;
+    }
+
+    if (result.fine.overdue) {
+        std::cout << "[!] Book is overdue by " << result.fine.daysOverdue << " days.\n";
+        std::cout << "Fine: RM" << result.fine.amount << "\n";
+    } else {
+        std::cout << "Returned on time. No fine.\n";
+    }
+    std::cout << "Book returned successfully.\n";
+}
+
+void LibraryConsole::displayBorrowedBooks(const UserInfo& mem) {
+    newScreen();
+    std::vector<Book> myBooks = library.borrowedBy(mem.id);
+    if (myBooks.empty()) {
+        std::cout << "You currently have no borrowed books.\n\n";
+        return;
+    }
+
+    std::cout << "Your Borrowed Books:\n";
+    TableWriter table = bookTable();
+    for (const Book& b : myBooks) bookRow(table, b);
+    table.finish();
+    std::cout << "\n";
+}
+
+void LibraryConsole::displayHistory(const UserInfo& mem) {
+    newScreen();
+    std::cout << "History for " << mem.name << ":\n";
+    size_t total = library.historySize(mem.id);
+    if (total == 0) {
+        std::cout << " - No history available.\n\n";
+        return;
+    }
+
+    // Newest page first; each page only copies its own entries
+    const size_t pageSize = 20;
+    const time_t from = std::numeric_limits<time_t>::min(), to = std::numeric_limits<time_t>::max();
+    size_t end = total;
+    while (true) {
+        size_t start = end > pageSize ? end - pageSize : 0;
+        {
+            TableWriter table(std::cout, TableFormat::Text, {{"Date", 15}, {"Action", 10}, {"Book Title", 0}}, 60);
+            for (const HistoryEntry& entry : library.historyOf(mem.id, from, to, start, end - start)) {
+                table.dateCell(entry.time);
+                table.cell(historyActionName(entry.action));
+                table.cell(entry.title);
+                table.endRow();
+            }
+        }
+        std::cout << "Entries " << start + 1 << "-" << end << " of " << total << "\n\n";
+        if (start == 0) break;
+
+        char ch;
+        std::cout << "Show older entries? (y/n): ";
+        std::cin >> ch;
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        if (ch != 'y' && ch != 'Y') break;
+        end = start;
+    }
+}
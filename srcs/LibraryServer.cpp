@@ -0,0 +1,184 @@
+#include "LibraryServer.hpp"
+#include "TextScanner.hpp"
+#include "Metrics.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const size_t MAX_RESULTS = 50;
+static const size_t MAX_REQUEST = 4096;
+
+static bool sendAll(int fd, const std::string& data) {
+    const char* p = data.data();
+    size_t left = data.size();
+    while (left > 0) {
+        ssize_t n = ::send(fd, p, left, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        p += n;
+        left -= n;
+    }
+    return true;
+}
+
+static std::string statusText(OpStatus status) {
+    switch (status) {
+        case OpStatus::Ok: return "OK 0\n";
+        case OpStatus::NoSuchBook: return "ERR no such book\n";
+        case OpStatus::NoSuchMember: return "ERR no such member\n";
+        case OpStatus::NoSuchUser: return "ERR no such user\n";
+        case OpStatus::Unavailable: return "ERR unavailable\n";
+        case OpStatus::NotBorrower: return "ERR not borrowed by this member\n";
+        case OpStatus::DuplicateId: return "ERR ID already in use\n";
+        case OpStatus::NotAllowed: return "ERR not allowed\n";
+    }
+    return "ERR\n";
+}
+
+static std::string bookList(const std::vector<Book>& found) {
+    std::string out = "OK " + std::to_string(found.size()) + "\n";
+    for (const Book& b : found) {
+        for (std::string_view field : {b.getId(), b.getTitle(), b.getAuthor(), b.getGenre()}) {
+            out += field;
+            out += '|';
+        }
+        out += (b.getIsBorrowed() ? "Borrowed|" + std::to_string(b.getDueDate()) : "Available|-") + "\n";
+    }
+    return out;
+}
+
+LibraryServer::LibraryServer(LibrarySystem& library, const std::string& socketPath)
+    : library(library), socketPath(socketPath), listenFd(-1), stopping(false) {}
+
+LibraryServer::~LibraryServer() {
+    stop();
+}
+
+bool LibraryServer::start() {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(addr.sun_path)) return false;
+    std::strcpy(addr.sun_path, socketPath.c_str());
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) return false;
+    ::unlink(socketPath.c_str()); // left behind by a previous run
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd, 128) != 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    library.enableConcurrentSessions();
+    stopping = false;
+    acceptor = std::thread(&LibraryServer::acceptLoop, this);
+    return true;
+}
+
+void LibraryServer::stop() {
+    if (listenFd < 0) return;
+    stopping = true;
+    ::shutdown(listenFd, SHUT_RDWR);
+    if (acceptor.joinable()) acceptor.join();
+    ::close(listenFd);
+    listenFd = -1;
+    ::unlink(socketPath.c_str());
+
+    std::unique_lock<std::mutex> lock(sessionsLock);
+    for (int fd : sessionFds) ::shutdown(fd, SHUT_RDWR);
+    sessionsDone.wait(lock, [this] { return sessionFds.empty(); });
+}
+
+void LibraryServer::acceptLoop() {
+    while (!stopping) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            // Listener closed or shut down: nothing more will arrive
+            if (stopping || errno == EBADF || errno == EINVAL) return;
+            // Out of descriptors or memory: back off instead of spinning on
+            // the same error until a session closes
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(sessionsLock);
+        sessionFds.push_back(fd);
+        std::thread(&LibraryServer::serveSession, this, fd).detach();
+    }
+}
+
+void LibraryServer::serveSession(int fd) {
+    std::string pending;
+    char buffer[4096];
+    bool open = true;
+    while (open) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        pending.append(buffer, n);
+
+        // Answer every complete line received so far
+        size_t start = 0, newline;
+        while (open && (newline = pending.find('\n', start)) != std::string::npos) {
+            std::string request = pending.substr(start, newline - start);
+            start = newline + 1;
+            if (!request.empty() && request.back() == '\r') request.pop_back();
+            if (request == "QUIT") open = false;
+            else if (!sendAll(fd, handle(request))) open = false;
+        }
+        pending.erase(0, start);
+        if (pending.size() > MAX_REQUEST) {
+            sendAll(fd, "ERR request too long\n");
+            open = false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(sessionsLock);
+    sessionFds.erase(std::find(sessionFds.begin(), sessionFds.end(), fd));
+    ::close(fd);
+    sessionsDone.notify_all();
+}
+
+std::string LibraryServer::handle(const std::string& request) {
+    FieldSplitter words(request, ' ');
+    std::string_view command, member, book;
+    words.next(command);
+
+    if (command == "SEARCH") return bookList(library.search(std::string(words.rest()), 0, MAX_RESULTS));
+    if (command == "METRICS") {
+        std::string dump = Metrics::global().prometheus();
+        return "OK " + std::to_string(std::count(dump.begin(), dump.end(), '\n')) + "\n" + dump;
+    }
+    // Recognise the command before asking for its arguments
+    bool takesBook = command == "BORROW" || command == "RESERVE" || command == "RETURN";
+    if (!takesBook && command != "LOANS" && command != "HISTORY") return "ERR unknown command\n";
+    if (!words.next(member)) return "ERR missing member ID\n";
+    if (command == "LOANS") return bookList(library.borrowedBy(std::string(member)));
+    if (command == "HISTORY") {
+        std::string_view from, to, offset;
+        long long range[3] = {0, std::numeric_limits<time_t>::max(), 0};
+        if (words.next(from) && (!parseInt(from, range[0]) || !words.next(to) || !parseInt(to, range[1])))
+            return "ERR expected HISTORY <member> [from to [offset]]\n";
+        if (words.next(offset) && (!parseInt(offset, range[2]) || range[2] < 0))
+            return "ERR bad offset\n";
+        std::vector<HistoryEntry> page = library.historyOf(std::string(member), range[0], range[1],
+                                                           range[2], MAX_RESULTS);
+        std::string out = "OK " + std::to_string(page.size()) + "\n";
+        for (const HistoryEntry& e : page) {
+            out += std::to_string(e.time) + "|";
+            out += historyActionName(e.action);
+            out += "|";
+            out += e.title;
+            out += "\n";
+        }
+        return out;
+    }
+    if (!words.next(book)) return "ERR missing book ID\n";
+    if (command == "BORROW") return statusText(library.borrow(std::string(member), std::string(book)));
+    if (command == "RESERVE") return statusText(library.reserve(std::string(member), std::string(book)));
+    return statusText(library.returnBook(std::string(member), std::string(book)).status);
+}
@@ -1,4 +1,7 @@
 #include "LibrarySystem.hpp"
+#include "Snapshot.hpp"
+#include "TextScanner.hpp"
+#include "Metrics.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -7,655 +10,1126 @@
 #include <cctype> 
 #include <iomanip>
 #include <ctime>
+#include <atomic>
+#include <thread>
+#include <cmath>
 
-/* HELPERS */
-int getValidInt() {
-    int choice;
-    while (true) {
-        std::cin >> choice;
-        if (std::cin.fail()) {
-            std::cin.clear(); 
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); 
-            std::cout << "Invalid input. Please enter a number: ";
-        } else {
-            return choice;
-        }
-    }
+/* Constructor and Destructor */
+
+LibrarySystem::LibrarySystem(DataFormat format, const std::string& dataDir, unsigned loadThreads,
+                             AccessMode access)
+    : searchIndex(books), searchIndexReady(false), facets(books), facetsReady(false), fuzzyIndex(books),
+      fuzzyReady(false), versionsReady(false), loadThreads(loadThreads),
+      bookFile(dataDir + "/books.txt"), userFile(dataDir + "/users.txt"),
+      snapshotFile(dataDir + "/library.snap"), format(format), access(access),
+      textExport(false), wal(dataDir + "/library.wal"), logging(false), bookCheckpoint(0), userCheckpoint(0),
+      batching(false), openChanges(0) {
+    loadData();
+}
+
+LibrarySystem::~LibrarySystem() {
+    saveData();
+}
+
+/* File Persistence */
+void LibrarySystem::setTextExport(bool enabled) {
+    textExport = enabled;
 }
 
-std::string toLower(const std::string& str) {
-    std::string lowerStr = str;
-    std::transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(), tolower);
-    return lowerStr;
+void LibrarySystem::saveData() {
+    if (access == AccessMode::ReadOnly) return;
+    ScopedTimer timer(Metrics::Op::Save);
+    if (!checkpoint(false))
+        std::cerr << "[Error] Could not save data files. Changes are kept in the operation log.\n";
 }
 
-/* FORMATTING */
-// Truncates text with "..." if too long, or adds spaces if too short
-std::string formatCell(std::string text, size_t width) {
-    if (text.length() > width) {
-        return text.substr(0, width - 3) + "...";
+// "Checkpoint|<lsn>" is skipped by loaders that predate the operation log
+std::string LibrarySystem::serializeBooks(uint64_t lsn) const {
+    std::string out = "Checkpoint|" + std::to_string(lsn) + "\n";
+    for (const auto& book : books) {
+        out += book.toFileString();
+        out += '\n';
     }
-    return text + std::string(width - text.length(), ' ');
+    return out;
 }
 
-// Format time_t to string "Jan 1 2025"
-std::string formatDate(time_t t) {
-    struct tm* timeInfo = localtime(&t);
-    if (!timeInfo) return "Unknown"; // Safety check
-    
-    char buffer[20];
-    // %b = Abbreviated Month, %d = Day, %Y = Year
-    strftime(buffer, sizeof(buffer), "%b %d %Y", timeInfo); 
-    return std::string(buffer);
+std::string LibrarySystem::serializeUsers(uint64_t lsn) const {
+    std::string out = "Checkpoint|" + std::to_string(lsn) + "\n";
+    for (const Librarian* librarian : users.librarians()) {
+        out += librarian->toFileString();
+        out += '\n';
+    }
+    for (const Member* member : users.members()) {
+        out += member->toFileString();
+        out += '\n';
+    }
+    return out;
 }
 
-void printTitle() {
-    std::cout << "=======================================\n";
-    std::cout << "   SMART LIBRARY MANAGEMENT SYSTEM     \n";
-    std::cout << "=======================================\n";
+bool LibrarySystem::checkpoint(bool async) {
+    // Serialize now, while the state matches the log position; the writer
+    // owns the buffers so it can run on the log's compaction thread
+    uint64_t lsn = wal.lastLsn();
+    bool binary = format == DataFormat::Binary;
+    std::string snapshot, bookText, userText;
+    if (binary) snapshot = buildSnapshot(books, users, lsn);
+    if (!binary || textExport || snapshot.empty()) {
+        bookText = serializeBooks(lsn);
+        userText = serializeUsers(lsn);
+    }
+
+    std::string snapPath = snapshotFile, bookPath = bookFile, userPath = userFile;
+    auto writeBase = [snapshot, bookText, userText, snapPath, bookPath, userPath]() {
+        bool ok = true;
+        if (!snapshot.empty()) ok = OperationLog::writeFileAtomic(snapPath, snapshot);
+        if (!bookText.empty()) {
+            ok = OperationLog::writeFileAtomic(bookPath, bookText) && ok;
+            ok = OperationLog::writeFileAtomic(userPath, userText) && ok;
+        }
+        return ok;
+    };
+    return wal.checkpoint(writeBase, async);
 }
 
-// Header for listing books
-void printHeader() {
-    std::cout << std::string(110, '-') << "\n";
-    std::cout << formatCell("ID", 8) << " | "
-              << formatCell("Title", 30) << " | "
-              << formatCell("Author", 20) << " | "
-              << formatCell("Genre", 15) << " | "
-              << formatCell("Status", 10) << " | "
-              << "Due Date\n";
-    std::cout << std::string(110, '-') << "\n";
+void LibrarySystem::maybeCompact() {
+    // Amortized O(1): the log is folded once it outgrows the base it replays onto
+    size_t threshold = std::max<size_t>(10000, books.size() + users.size());
+    if (wal.recordsSinceCheckpoint() >= threshold && !wal.compactionRunning())
+        checkpoint(true);
 }
 
-// Print books
-void printBookRow(const Book& b) {
-    std::string status = b.getIsBorrowed() ? "Borrowed" : "Available";
-    std::string dueDateStr = "-";
+// Last record this thread logged, and for which system: the operation
+// waits for it to be durable before it reports success
+static thread_local const LibrarySystem* pendingOwner = nullptr;
+static thread_local uint64_t pendingLsn = 0;
 
-    if (b.getIsBorrowed()) {
-        dueDateStr = formatDate(b.getDueDate());
+void LibrarySystem::logOp(const std::string& op, std::initializer_list<std::string_view> fields) {
+    if (!logging) return;
+    uint64_t lsn = wal.append(op, fields);
+    if (!lsn) {
+        std::cerr << "[Error] Could not write to the operation log.\n";
+        return;
     }
+    pendingOwner = this;
+    pendingLsn = lsn;
+    // No checkpoint here: a record is often logged before its change is
+    // applied, and a base saved in between would claim the record's LSN
+    // without containing it. Every operation calls commitOperation() once
+    // it has finished.
+}
 
-    std::cout << formatCell(b.getId(), 8) << " | "
-              << formatCell(b.getTitle(), 30) << " | "
-              << formatCell(b.getAuthor(), 20) << " | "
-              << formatCell(b.getGenre(), 15) << " | "
-              << formatCell(status, 10) << " | "
-              << dueDateStr << "\n";
+void LibrarySystem::commitOperation() {
+    if (pendingOwner == this && pendingLsn) wal.waitDurable(pendingLsn);
+    pendingLsn = 0;
+    if (wal.recordsSinceCheckpoint() < 10000 || wal.compactionRunning()) return;
+    std::unique_lock<std::shared_mutex> lock(stateLock);
+    maybeCompact();
 }
 
-/* Constructor and Destructor */
+void LibrarySystem::loadData() {
+    ScopedTimer timer(Metrics::Op::Load);
+    if (format != DataFormat::Binary || !loadSnapshot())
+        loadTextData();
+    replayLog();
+    bookIds.clear();
+    for (const Book& b : books) bookIds.take(b.getId());
+
+    size_t unparsed = 0;
+    for (const Member* m : users.members()) unparsed += m->getHistory().unparsedCount();
+    if (unparsed)
+        std::cerr << "[System] " << unparsed << " history entries could not be read; they are kept as-is.\n";
 
-LibrarySystem::LibrarySystem() {
-    loadData();
+    if (users.empty()) {
+        // stderr, so the notice never lands in a --format json/tsv listing
+        std::cerr << "[System] No users found. Creating Default Admin account.\n";
+        std::cerr << "[System] ID: admin | Name: Admin\n";
+        addUser(users.newLibrarian("admin", "Admin", "admin@library.com"));
+    }
 }
 
-LibrarySystem::~LibrarySystem() {
-    saveData();
-    for (auto user : users) {
-        delete user;
+void LibrarySystem::replayLog() {
+    // Records between BATCH and COMMIT are applied together. A batch cut off
+    // by a crash is dropped, and ROLLBACK is logged so the records after it
+    // are not mistaken for part of it next time.
+    std::vector<LogRecord> batch;
+    bool inBatch = false;
+    uint64_t last = wal.replay([this, &batch, &inBatch](const LogRecord& record) {
+        if (record.op == "BATCH") {
+            inBatch = true;
+            batch.clear();
+        } else if (record.op == "COMMIT") {
+            for (const LogRecord& r : batch) applyLogRecord(r);
+            batch.clear();
+            inBatch = false;
+        } else if (record.op == "ROLLBACK") {
+            batch.clear();
+            inBatch = false;
+        } else if (inBatch) {
+            batch.push_back(record);
+        } else {
+            applyLogRecord(record);
+        }
+    });
+    if (access == AccessMode::ReadOnly) return;
+    uint64_t next = std::max(last, std::max(bookCheckpoint, userCheckpoint)) + 1;
+    if (!wal.open(next))
+        std::cerr << "[Error] Could not open the operation log; changes will only be saved on exit.\n";
+    logging = true;
+    if (inBatch) logOp("ROLLBACK", {});
+}
+
+void LibrarySystem::applyLogRecord(const LogRecord& r) {
+    const std::string& op = r.op;
+    const std::vector<std::string>& f = r.fields;
+    bool userOp = op == "ADDUSER" || op == "RMUSER" || op == "HISTORY";
+    if (r.lsn <= (userOp ? userCheckpoint : bookCheckpoint)) return; // already in the base
+
+    if (op == "ADDUSER" && f.size() >= 4) {
+        if (findUser(f[1])) return;
+        if (f[0] == "Librarian") addUser(users.newLibrarian(f[1], f[2], f[3]));
+        else if (f[0] == "Member") addUser(users.newMember(f[1], f[2], f[3]));
+    } else if (op == "RMUSER" && f.size() >= 1) {
+        eraseUser(f[0]);
+    } else if (op == "HISTORY" && f.size() >= 4) {
+        Member* m = asMember(findUser(f[0]));
+        long long time;
+        HistoryAction action;
+        if (m && parseInt(f[1], time) && parseHistoryAction(f[2], action))
+            m->appendHistory(static_cast<time_t>(time), action, f[3]);
+    } else if (op == "ADDBOOK" && f.size() >= 5) {
+        long long due = 0;
+        parseInt(f[4], due);
+        if (findBookHandle(f[0]) == INVALID_BOOK)
+            addToCatalogue(Book(f[0], f[1], f[2], f[3], static_cast<time_t>(due)));
+    } else if (f.size() >= 1) {
+        BookHandle handle = findBookHandle(f[0]);
+        if (handle == INVALID_BOOK) return;
+        if (op == "RMBOOK") removeFromCatalogue(handle);
+        else if (op == "BORROW" && f.size() >= 3) {
+            long long due = 0;
+            parseInt(f[2], due);
+            checkOut(handle, f[1], 0, static_cast<time_t>(due));
+        }
+        else if (op == "RETURN") { if (books.get(handle).getIsBorrowed()) checkIn(handle); }
+        else if (op == "RESERVE" && f.size() >= 2) reserveBook(handle, f[1]);
+        else if (op == "POPRES") {
+            // Pops name the member they removed; concurrent reservations may
+            // have been logged in a different order than they were queued
+            if (f.size() >= 2) books.get(handle).removeReservation(f[1]);
+            else popReservation(handle);
+        }
     }
-    users.clear();
 }
 
-/* File Persistence */
-void LibrarySystem::saveData() {
-    std::ofstream bOut(bookFile);
-    for (const auto& book : books) {
-        bOut << book.toFileString() << "\n";
+bool LibrarySystem::loadSnapshot() {
+    SnapshotView snap;
+    if (!snap.open(snapshotFile)) return false;
+    bookCheckpoint = userCheckpoint = snap.logSequence();
+
+    books.reserve(snap.bookCount());
+    bookIndex.reserve(snap.bookCount());
+    userIndex.reserve(snap.userCount());
+    for (size_t i = 0; i < snap.bookCount(); i++) {
+        const SnapBook& r = snap.book(i);
+        Book b(std::string(snap.str(r.id)), std::string(snap.str(r.title)),
+               std::string(snap.str(r.author)), std::string(snap.str(r.genre)), static_cast<time_t>(r.dueDate));
+        for (uint32_t k = 0; k < r.reservationCount; k++)
+            b.addReservation(std::string(snap.str(snap.reservation(r.reservationBegin + k))));
+        BookHandle handle = addToCatalogue(std::move(b));
+        if (r.borrowed) checkOut(handle, std::string(snap.str(r.borrower)), 0, static_cast<time_t>(r.dueDate));
     }
-    bOut.close();
 
-    std::ofstream uOut(userFile);
-    for (const auto& user : users) {
-        if (user->getRole() != "Guest") {
-            uOut << user->toFileString() << "\n";
+    for (size_t i = 0; i < snap.userCount(); i++) {
+        const SnapUser& r = snap.user(i);
+        std::string id(snap.str(r.id)), name(snap.str(r.name)), email(snap.str(r.email));
+        if (r.role == SNAP_LIBRARIAN) {
+            addUser(users.newLibrarian(id, name, email));
+        } else if (r.role == SNAP_MEMBER) {
+            Member* m = users.newMember(id, name, email);
+            for (uint32_t k = 0; k < r.historyCount; k++) {
+                if (snap.version() < 3) {
+                    m->loadHistory(snap.str(snap.historyV2(r.historyBegin + k)));
+                    continue;
+                }
+                const SnapHistory& h = snap.history(r.historyBegin + k);
+                if (h.action == SNAP_HISTORY_UNPARSED) m->loadHistory(snap.str(h.title));
+                else m->appendHistory(static_cast<time_t>(h.time), static_cast<HistoryAction>(h.action), snap.str(h.title));
+            }
+            addUser(m);
         }
     }
-    uOut.close();
+    return true;
 }
 
-void LibrarySystem::loadData() {
-    std::ifstream bIn(bookFile);
-    std::string line;
-    while (std::getline(bIn, line)) {
-        if(line.empty()) continue;
-        std::stringstream ss(line);
-        std::string segment;
-        std::vector<std::string> seglist;
-        while (std::getline(ss, segment, '|')) {
-            seglist.push_back(segment);
-        }
-        if (seglist.size() >= 7) {
-            Book b(seglist[0], seglist[1], seglist[2], seglist[3], \
-				static_cast<time_t>(std::stoll(seglist[5])));
-			bool borrowed = (seglist[4] == "1");
-            std::string borrower = seglist[6];
-            
-            if (borrowed) b.borrowBook(borrower, 0, static_cast<time_t>(std::stoll(seglist[5]))); 
-
-            if (seglist.size() > 7) {
-                b.loadReservationsFromString(seglist[7]);
+namespace {
+
+// What one worker produces from its slice of a data file. Chunks are merged
+// in file order, so the result matches a sequential load.
+struct ParsedBook {
+    Book book;
+    bool borrowed;
+    std::string borrower;
+};
+
+struct LoadChunk {
+    std::string_view text;
+    bool isBooks;
+    std::vector<ParsedBook> books;
+    UserStore owner; // constructs this chunk's users; adopted by the merge
+    std::vector<Person*> users;
+    bool hasCheckpoint = false;
+    uint64_t checkpoint = 0;
+};
+
+void parseBookChunk(LoadChunk& chunk) {
+    LineReader lines(chunk.text);
+    std::string_view line, seglist[8];
+    long long number;
+    while (lines.next(line)) {
+        if (line.empty()) continue;
+        size_t count = splitFields(line, '|', seglist, 8);
+        if (count == 2 && seglist[0] == "Checkpoint") {
+            if (parseInt(seglist[1], number)) {
+                chunk.hasCheckpoint = true;
+                chunk.checkpoint = number;
             }
-            books.push_back(b);
+            continue;
         }
-    }
-    bIn.close();
+        if (count < 7) continue;
 
-    std::ifstream uIn(userFile);
-    while (std::getline(uIn, line)) {
-        if(line.empty()) continue;
-        std::stringstream ss(line);
-        std::string type, id, name, email, history;
-        std::getline(ss, type, '|');
-        std::getline(ss, id, '|');
-        std::getline(ss, name, '|');
-        std::getline(ss, email, '|');
+        time_t due = parseInt(seglist[5], number) ? static_cast<time_t>(number) : 0;
+        Book b{std::string(seglist[0]), std::string(seglist[1]), std::string(seglist[2]),
+               std::string(seglist[3]), due};
+        if (count > 7) {
+            b.loadReservationsFromString(seglist[7]);
+        }
+        chunk.books.push_back(ParsedBook{std::move(b), seglist[4] == "1", std::string(seglist[6])});
+    }
+}
 
-        if (type == "Librarian") {
-            users.push_back(new Librarian(id, name, email));
-        } else if (type == "Member") {
-            Member* m = new Member(id, name, email);
-            if (std::getline(ss, history)) {
-                m->loadHistory(history);
+void parseUserChunk(LoadChunk& chunk) {
+    LineReader lines(chunk.text);
+    std::string_view line;
+    long long number;
+    while (lines.next(line)) {
+        if (line.empty()) continue;
+        FieldSplitter fields(line, '|');
+        std::string_view type, id, name, email;
+        fields.next(type);
+        fields.next(id);
+        fields.next(name);
+        fields.next(email);
+
+        if (type == "Checkpoint") {
+            if (parseInt(id, number)) {
+                chunk.hasCheckpoint = true;
+                chunk.checkpoint = number;
             }
-            users.push_back(m);
+        } else if (type == "Librarian") {
+            chunk.users.push_back(chunk.owner.newLibrarian(std::string(id), std::string(name), std::string(email)));
+        } else if (type == "Member") {
+            Member* m = chunk.owner.newMember(std::string(id), std::string(name), std::string(email));
+            m->loadHistory(fields.rest());
+            chunk.users.push_back(m);
         }
     }
-    uIn.close();
+}
 
-    if (users.empty()) {
-        std::cout << "[System] No users found. Creating Default Admin account.\n";
-        std::cout << "[System] ID: admin | Name: Admin\n"; 
-        users.push_back(new Librarian("admin", "Admin", "admin@library.com"));
+// Below this a file is parsed as a single chunk; thread start-up would cost
+// more than it saves
+const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+} // namespace
+
+void LibrarySystem::loadTextData() {
+    // Fields are views into the mapped files; only the stored strings allocate
+    MappedFile bIn, uIn;
+    bIn.open(bookFile);
+    uIn.open(userFile);
+
+    unsigned threads = loadThreads ? loadThreads : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<LoadChunk> chunks;
+    for (int isBooks = 1; isBooks >= 0; isBooks--) {
+        std::string_view text = isBooks ? bIn.view() : uIn.view();
+        size_t parts = std::min<size_t>(threads * 4, text.size() / MIN_CHUNK_BYTES + 1);
+        for (std::string_view piece : splitAtLines(text, parts)) {
+            chunks.emplace_back();
+            chunks.back().text = piece;
+            chunks.back().isBooks = isBooks;
+        }
+    }
+
+    // Workers pull chunks off a shared counter; both files share the pool
+    std::atomic<size_t> nextChunk(0);
+    auto work = [&chunks, &nextChunk]() {
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++) {
+            if (chunks[i].isBooks) parseBookChunk(chunks[i]);
+            else parseUserChunk(chunks[i]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<size_t>(threads, chunks.size()); t++) pool.emplace_back(work);
+    work();
+    for (auto& worker : pool) worker.join();
+
+    // Merge on this thread in file order: books first, then users
+    size_t bookCount = 0, userCount = 0;
+    for (const auto& chunk : chunks) {
+        bookCount += chunk.books.size();
+        userCount += chunk.users.size();
+    }
+    books.reserve(bookCount);
+    bookIndex.reserve(bookCount);
+    userIndex.reserve(userCount);
+    for (auto& chunk : chunks) {
+        if (chunk.hasCheckpoint) (chunk.isBooks ? bookCheckpoint : userCheckpoint) = chunk.checkpoint;
+        for (auto& parsed : chunk.books) {
+            BookHandle handle = addToCatalogue(std::move(parsed.book));
+            if (parsed.borrowed) checkOut(handle, parsed.borrower, 0, books.get(handle).getDueDate());
+        }
+        users.adopt(chunk.owner);
+        for (Person* user : chunk.users) addUser(user);
     }
 }
 
 /* Additional helpers */
-Person* LibrarySystem::findUser(std::string id) {
-    for (auto user : users) {
-        if (user->getId() == id) return user;
+BookHandle LibrarySystem::addToCatalogue(Book book) {
+    BookHandle handle = storeBook(std::move(book));
+    if (searchIndexReady) searchIndex.add(handle);
+    return handle;
+}
+
+BookHandle LibrarySystem::storeBook(Book book) {
+    std::string_view id = book.getId();
+    BookHandle handle = books.add(std::move(book));
+    bookIndex.insert(id, handle);
+    bookIds.take(id);
+    invalidateSearches(handle);
+    if (facetsReady) facets.add(handle);
+    if (fuzzyReady) fuzzyIndex.add(handle);
+    const Book& b = books.get(handle);
+    if (versionsReady) {
+        versions.putBook(handle, b);
+        publishVersion();
     }
-    return nullptr;
+    logOp("ADDBOOK", {id, b.getTitle(), b.getAuthor(), b.getGenre(), std::to_string(b.getDueDate())});
+    return handle;
 }
 
-Book* LibrarySystem::findBook(std::string id) {
-    for (auto& book : books) {
-        if (book.getId() == id) return &book;
+void LibrarySystem::removeFromCatalogue(BookHandle handle) {
+    if (books.get(handle).getIsBorrowed()) checkIn(handle);
+    if (searchIndexReady) searchIndex.remove(handle);
+    invalidateSearches(handle);
+    if (facetsReady) facets.remove(handle);
+    if (fuzzyReady) fuzzyIndex.remove(handle);
+    if (versionsReady) {
+        versions.eraseBook(handle);
+        publishVersion();
     }
-    return nullptr;
+    std::string_view id = books.get(handle).getId();
+    bookIndex.erase(id);
+    bookIds.release(id);
+    logOp("RMBOOK", {id}); // while the record that id points into is live
+    books.remove(handle);
 }
 
-void LibrarySystem::calculateFine(time_t dueDate) {
-    time_t now = time(0);
-    double seconds = difftime(now, dueDate);
-    if (seconds > 0) {
-        int daysOverdue = (int)(seconds / (60 * 60 * 24));
-        std::cout << "[!] Book is overdue by " << daysOverdue << " days.\n";
-        std::cout << "Fine: RM" << daysOverdue * 0.50 << "\n"; 
-    } else {
-        std::cout << "Returned on time. No fine.\n";
+void LibrarySystem::addUser(Person* user) {
+    users.add(user);
+    userIndex.insert(user->getId(), user);
+    if (versionsReady) {
+        versions.putUser(*user);
+        publishVersion();
     }
+    logOp("ADDUSER", {user->getRole(), user->getId(), user->getName(), user->getEmail()});
 }
 
-/* Menus */
-bool LibrarySystem::run() {
-    printTitle();
-	std::cout << "Login as: \n";
-    std::cout << "1. Librarian\n";
-    std::cout << "2. Member\n";
-    std::cout << "3. Guest (Seach only)\n";
-    std::cout << "0. Exit Program\n";
-    std::cout << "---------------------------------------\n";
-    std::cout << "Choice: ";
-    
-    int choice = getValidInt();
+bool LibrarySystem::eraseUser(const std::string& id) {
+    Person* const* user = userIndex.find(id);
+    if (!user) return false;
+    Person* found = *user;
+    userIndex.erase(id);
+    if (versionsReady) {
+        versions.eraseUser(id);
+        publishVersion();
+    }
+    users.erase(found);
+    logOp("RMUSER", {id});
+    return true;
+}
 
-    if (choice == 0) return false; 
+void LibrarySystem::reserveBook(BookHandle handle, const std::string& memberId) {
+    Book& book = books.get(handle);
+    // Logged before it is queued, so a pop of it is always logged after it
+    logOp("RESERVE", {book.getId(), memberId});
+    book.addReservation(memberId);
+}
 
-    if (choice == 3) {
-        guestMenu();
-        return true; 
-    }
+std::string LibrarySystem::popReservation(BookHandle handle) {
+    Book& book = books.get(handle);
+    std::string next = book.processNextReservation();
+    logOp("POPRES", {book.getId(), next});
+    return next;
+}
+
+void LibrarySystem::recordHistory(Member* mem, std::string_view title, HistoryAction action) {
+    std::lock_guard<std::mutex> lock(historyLock);
+    HistoryEntry entry = mem->addToHistory(title, action);
+    logOp("HISTORY", {mem->getId(), std::to_string(entry.time), historyActionName(action), title});
+}
 
-    if (choice != 1 && choice != 2) {
-        std::cout << "Invalid choice.\n\n";
-        return true; 
+void LibrarySystem::returnAndHandOver(BookHandle handle, Member* mem) {
+    Book& book = books.get(handle);
+    // One version for the return and the hand-over together. The change is
+    // held open across the steps, so a publish from another session in
+    // between cannot show the book back on the shelf with its queue popped
+    {
+        std::lock_guard<std::mutex> lock(loansLock);
+        openChanges++;
     }
+    checkIn(handle, false);
+    while (book.hasReservations()) {
+        std::string nextUser = popReservation(handle);
+        Member *tmp = asMember(findUser(nextUser));
+        if (!tmp) continue;
+        checkOut(handle, tmp->getId(), 7, 0, false);
+        recordHistory(tmp, book.getTitle(), HistoryAction::Borrowed);
+        break;
+    }
+    {
+        std::lock_guard<std::mutex> lock(loansLock);
+        openChanges--;
+        publishVersion();
+    }
+    if (mem) recordHistory(mem, book.getTitle(), HistoryAction::Returned);
+}
 
-	std::cout << "Logging in as: " << ((choice == 1) ? "Librarian\n" : "Member\n");
-    std::string id;
-    std::cout << "Enter User ID: ";
-    std::cin >> id;
+void LibrarySystem::ensureSearchIndex() {
+    if (searchIndexReady) return;
+    for (auto it = books.begin(); it != books.end(); ++it) searchIndex.add(it.handle());
+    searchIndexReady = true;
+}
 
-    Person* user = findUser(id);
-    if (!user) {
-        std::cout << "[Error] Invalid ID. (Hint: Try 'admin' if first run)\n\n";
-        return true; 
-    }
-
-    if (choice == 1 && dynamic_cast<Librarian*>(user))
-        librarianMenu(dynamic_cast<Librarian*>(user));
-    else if (choice == 2 && dynamic_cast<Member*>(user))
-        memberMenu(dynamic_cast<Member*>(user));
-    else
-        std::cout << "[Error] Access Denied or Wrong Role.\n\n";
-    return true; 
-}
-
-void LibrarySystem::librarianMenu(Librarian* lib) {
-	std::system("clear");
-	printTitle();
-    int choice;
-    do {
-        std::cout << "--- Librarian Menu (" << lib->getName() << ") ---\n";
-        std::cout << "1. Add Book\t\t4. Add User\t\t0. Logout\n";
-		std::cout << "2. Remove Book\t\t5. Remove User\n";
-		std::cout << "3. Display all books\t6. Display all users\nChoice: ";
-        
-        choice = getValidInt();
-
-        switch (choice) {
-            case 1: addBook(); break;
-            case 2: removeBook(); break;
-            case 3: displayAllBooks(); break;
-            case 4: registerUser(); break; 
-            case 5: removeUser(); break;
-			case 6: displayAllUsers(); break;
-            case 0: std::cout << "Logging out...\n\n"; break;
-            default: std::cout << "Invalid option.\n\n";
-        }
-    } while (choice != 0);
-}
-
-void LibrarySystem::memberMenu(Member* mem) {
-	system("clear");
-	printTitle();
-    int choice;
-    do {
-        std::cout << "--- Member Menu (" << mem->getName() << ") ---\n";
-        std::cout << "1. Search Books\n2. Borrow Book\n3. Return Book\n";
-		std::cout << "4. View Borrowed Books\n5. View History\n0. Logout\nChoice: ";
-        
-        choice = getValidInt();
-
-        switch (choice) {
-            case 1: searchBooks(); break;
-            case 2: borrowBook(mem); break;
-            case 3: returnBook(mem); break;
-			case 4: displayBorrowedBooks(mem); break;
-            case 5: displayHistory(mem); break;
-            case 0: std::cout << "Logging out...\n\n"; break;
-            default: std::cout << "Invalid option.\n\n";
-        }
-    } while (choice != 0);
-}
-
-void LibrarySystem::guestMenu() {
-	std::system("clear");
-	printTitle();
-    std::cout << "--- Guest Menu ---\n";
-	std::string input;
-    
-	while(true) {
-		searchBooks();
-		std::cout << "Search for another book? (y/n): ";
-		std::cin >> input;
-		if (input != "y" && input != "Y")
-			break;
-	}
-
-    std::cout << "\nGuest access finished. Please register to borrow books.\n\n";
-}
-
-/* Core Functionalities */
-void LibrarySystem::addBook() {
-	std::system("clear");
-	printTitle();
-    std::string id, title, author, genre;
-    
-	int tmp_id = 1;
-	for (auto it = books.begin(); it != books.end(); ++it) {
-		if (stoi(it->getId()) != tmp_id)
-			break;
-		tmp_id++;
-	}
-    id = std::to_string(tmp_id);
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-    std::cout << "Enter Title: "; 
-    std::getline(std::cin, title);
-    std::cout << "Enter Author: "; 
-    std::getline(std::cin, author);
-    std::cout << "Enter Genre: "; 
-    std::getline(std::cin, genre);
-
-    books.emplace_back(id, title, author, genre, time(0));
-    std::cout << "Book added successfully.\n";
-}
-
-void LibrarySystem::removeBook() {
-	std::system("clear");
-	printTitle();
-	displayAllBooks();
+void LibrarySystem::invalidateSearches(BookHandle handle) {
+    // Nothing is cached until the index exists
+    if (!searchIndexReady) return;
+    std::vector<std::string> terms;
+    SearchIndex::collectTerms(books.get(handle), terms);
+    searchCache.invalidate(terms);
+}
+
+void LibrarySystem::ensureFacets() {
+    if (facetsReady) return;
+    for (auto it = books.begin(); it != books.end(); ++it) facets.add(it.handle());
+    facetsReady = true;
+}
+
+void LibrarySystem::ensureFuzzyIndex() {
+    if (fuzzyReady) return;
+    for (auto it = books.begin(); it != books.end(); ++it) fuzzyIndex.add(it.handle());
+    fuzzyReady = true;
+}
 
+void LibrarySystem::ensureVersions() {
+    if (versionsReady) return;
+    versions.clear();
+    for (auto it = books.begin(); it != books.end(); ++it) versions.putBook(it.handle(), *it);
+    for (const Librarian* l : users.librarians()) versions.putUser(*l);
+    for (const Member* m : users.members()) versions.putUser(*m);
+    versionsReady = true;
+    publishVersion();
+}
+
+void LibrarySystem::publishVersion() {
+    if (versionsReady && !batching && openChanges == 0) versions.publish();
+}
+
+std::string LibrarySystem::allocateBookId() {
+    // Only IDs past the allocator's range can already belong to a book
     std::string id;
-    std::cout << "Enter Book ID to remove: "; 
-    std::cin >> id; 
-    
-    bool found = false;
-    for (auto it = books.begin(); it != books.end(); ++it) {
-        if (it->getId() == id) {
-            books.erase(it);
-            found = true;
-            std::cout << "Book removed.\n";
-            break; 
+    do id = std::to_string(bookIds.allocate());
+    while (findBookHandle(id) != INVALID_BOOK);
+    return id;
+}
+
+Person* LibrarySystem::findUser(std::string id) {
+    Person* const* user = userIndex.find(id);
+    return user ? *user : nullptr;
+}
+
+BookHandle LibrarySystem::findBookHandle(const std::string& id) const {
+    ScopedTimer timer(Metrics::Op::FindBook);
+    const BookHandle* handle = bookIndex.find(id);
+    return handle ? *handle : INVALID_BOOK;
+}
+
+void LibrarySystem::checkOut(BookHandle handle, const std::string& memberId, int daysToBorrow, time_t due,
+                             bool publish) {
+    Book& book = books.get(handle);
+    if (book.getIsBorrowed()) checkIn(handle, false);
+    book.borrowBook(memberId, daysToBorrow, due);
+    logOp("BORROW", {book.getId(), memberId, std::to_string(book.getDueDate())});
+
+    std::lock_guard<std::mutex> lock(loansLock);
+    std::vector<BookHandle>* loans = loansByMember.find(memberId);
+    if (loans) loans->push_back(handle);
+    else loansByMember.insert(memberId, std::vector<BookHandle>(1, handle));
+    dueIndex.add(handle, book.getDueDate());
+    if (facetsReady) facets.setAvailable(handle, false);
+    if (versionsReady) {
+        versions.putBook(handle, book);
+        if (publish) publishVersion();
+    }
+}
+
+void LibrarySystem::checkIn(BookHandle handle, bool publish) {
+    Book& book = books.get(handle);
+    {
+        std::lock_guard<std::mutex> lock(loansLock);
+        std::vector<BookHandle>* loans = loansByMember.find(book.getBorrowedById());
+        if (loans) {
+            auto it = std::find(loans->begin(), loans->end(), handle);
+            if (it != loans->end()) loans->erase(it);
+            if (loans->empty()) loansByMember.erase(book.getBorrowedById());
+        }
+        dueIndex.remove(handle);
+        if (facetsReady) facets.setAvailable(handle, true);
+        book.returnBook();
+        if (versionsReady) {
+            versions.putBook(handle, book);
+            if (publish) publishVersion();
         }
     }
-    
-    if (!found) std::cout << "Book not found.\n";
+    logOp("RETURN", {book.getId()});
 }
 
-void LibrarySystem::displayAllBooks() {
-	std::system("clear");
-	printTitle();
-	std::cout << "--- Registered Books ---\n";
-    if(books.empty()) {
-        std::cout << "No books in library.\n";
-        return;
+Fine LibrarySystem::fineFor(time_t dueDate, time_t returnedAt) {
+    Fine fine = {false, 0, 0.0};
+    double seconds = difftime(returnedAt, dueDate);
+    if (seconds > 0) {
+        fine.overdue = true;
+        fine.daysOverdue = (int)(seconds / (60 * 60 * 24));
+        fine.amount = fine.daysOverdue * FINE_PER_DAY;
     }
+    return fine;
+}
 
-	std::cout << std::string(115, '-') << "\n";
-	std::cout << formatCell("ID", 8) << " | "
-	<< formatCell("Title", 30) << " | "
-	<< formatCell("Author", 20) << " | "
-	<< formatCell("Genre", 15) << " | "
-	<< formatCell("Due Date", 15) << " | "
-	<< "Borrower ID\n";
-	std::cout << std::string(115, '-') << "\n";
-
-	for (const auto& b : books) {
-			std::string dateStr = formatDate(b.getDueDate());
-
-			std::cout << formatCell(b.getId(), 8) << " | "
-						<< formatCell(b.getTitle(), 30) << " | "
-						<< formatCell(b.getAuthor(), 20) << " | "
-						<< formatCell(b.getGenre(), 15) << " | "
-						<< formatCell(dateStr, 15) << " | "
-						<< (b.getBorrowedById().empty() ? "N/A" : b.getBorrowedById()) << "\n";
-		}
-	std::cout << std::string(115, '-') << "\n";
-}
-
-void LibrarySystem::registerUser() {
-	std::system("clear");
-	printTitle();
-    std::cout << "Register New Account:\n1. Member\n2. Librarian\nChoice: ";
-    int type = getValidInt();
-    
-    if (type != 1 && type != 2) {
-        std::cout << "Invalid account type selected.\n";
-        return;
+/* Library API */
+void LibrarySystem::enableConcurrentSessions() {
+    std::unique_lock<std::shared_mutex> lock(stateLock);
+    // Built up front so searches and browsing stay read-only
+    ensureSearchIndex();
+    ensureFacets();
+    ensureFuzzyIndex();
+    ensureVersions();
+}
+
+CatalogueSnapshot LibrarySystem::snapshot() {
+    if (!versionsReady) {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        ensureVersions();
     }
+    return versions.pin();
+}
 
-    std::string id, name, email;
-    std::cout << "Enter New ID: "; std::cin >> id;
-    
-    if (findUser(id) != nullptr) {
-        std::cout << "[Error] User ID already exists!\n";
-        return;
+std::vector<Book> LibrarySystem::search(const std::string& query, size_t offset, size_t limit) {
+    ScopedTimer timer(Metrics::Op::Search);
+    Metrics::count(Metrics::Counter::Searches);
+    std::vector<Book> found;
+    // An empty query lists the whole catalogue. Once snapshots are kept it
+    // reads one, so a long listing holds no locks and shows a single point
+    // in time; before that it copies from the store rather than turn them on.
+    if (query.find_first_not_of(" \t") == std::string::npos) {
+        size_t skipped = 0;
+        if (versionsReady) {
+            snapshot().forEachBook([&](BookHandle, const BookRecord& record) {
+                if (found.size() >= limit) return false;
+                if (skipped++ >= offset) found.push_back(Book(record));
+                return true;
+            });
+            return found;
+        }
+        std::shared_lock<std::shared_mutex> lock(stateLock);
+        for (auto it = books.begin(); it != books.end() && found.size() < limit; ++it) {
+            if (skipped++ < offset) continue;
+            std::lock_guard<std::mutex> bookGuard(bookLock(it.handle()));
+            found.push_back(*it);
+        }
+        return found;
     }
 
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    
-    std::cout << "Enter Name: "; std::getline(std::cin, name);
-    std::cout << "Enter Email: "; std::cin >> email;
-    
-    if (type == 1) {
-        users.push_back(new Member(id, name, email));
-        std::cout << "Member registered successfully.\n";
+    // Without sessions the index is built by the first search; with them it
+    // already exists and this never takes the exclusive lock
+    if (!searchIndexReady) {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        ensureSearchIndex();
+    }
+    std::vector<std::string> terms = SearchIndex::tokenize(query);
+    std::string key = SearchCache::normalize(terms);
+    // Held from the lookup to the insert, so no add or remove (and its
+    // invalidation) can fall in between
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    SearchCache::Results handles = searchCache.find(key);
+    if (handles) {
+        Metrics::count(Metrics::Counter::SearchCacheHits);
     } else {
-        users.push_back(new Librarian(id, name, email));
-        std::cout << "Librarian registered successfully.\n";
+        Metrics::count(Metrics::Counter::SearchCacheMisses);
+        auto ranked = std::make_shared<std::vector<BookHandle>>();
+        for (const SearchResult& result : searchIndex.search(query)) ranked->push_back(result.book);
+        handles = ranked;
+        searchCache.insert(key, terms, handles);
     }
+    // Copied now, so availability is always current
+    for (size_t i = offset; i < handles->size() && i - offset < limit; i++) {
+        std::lock_guard<std::mutex> bookGuard(bookLock((*handles)[i]));
+        found.push_back(books.get((*handles)[i]));
+    }
+    return found;
 }
 
-void LibrarySystem::removeUser() {
-	std::system("clear");
-	printTitle();
+SearchCacheStats LibrarySystem::searchCacheStats() const {
+    return searchCache.stats();
+}
 
-	displayAllUsers();
-    std::string id;
-    std::cout << "Enter User ID to remove: "; std::cin >> id;
-    
-    if (id == "admin") {
-        std::cout << "[Error] Cannot remove the default admin account.\n";
-        return;
-    }
+void LibrarySystem::setSearchCacheCapacity(size_t bytes) {
+    searchCache.setCapacity(bytes);
+}
 
-    bool found = false;
-    for (auto it = users.begin(); it != users.end(); ++it) {
-        if ((*it)->getId() == id) {
-            delete *it; // Free memory
-            users.erase(it); // Remove node
-            found = true;
-            std::cout << "User removed.\n";
-            break;
-        }
+std::vector<FuzzyMatch> LibrarySystem::fuzzySearch(const std::string& query, size_t k) {
+    ScopedTimer timer(Metrics::Op::FuzzySearch);
+    Metrics::count(Metrics::Counter::Searches);
+    if (!fuzzyReady) {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        ensureFuzzyIndex();
+    }
+    std::vector<FuzzyMatch> found;
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    for (const FuzzyResult& result : fuzzyIndex.search(query, k)) {
+        std::lock_guard<std::mutex> bookGuard(bookLock(result.book));
+        found.push_back(FuzzyMatch{books.get(result.book), result.score});
     }
+    return found;
+}
 
-    if (!found) std::cout << "User not found.\n";
-}
-
-void LibrarySystem::displayAllUsers() {
-	std::system("clear");
-	printTitle();
-    std::cout << "--- Registered Users ---\n";
-    std::cout << std::string(90, '-') << "\n";
-    std::cout << formatCell("ID", 10) << " | "
-              << formatCell("Name", 30) << " | "
-              << formatCell("Email", 30) << " | "
-              << "Role\n";
-    std::cout << std::string(90, '-') << "\n";
-
-    for (const auto& user : users) {
-        std::cout << formatCell(user->getId(), 10) << " | "
-                  << formatCell(user->getName(), 30) << " | "
-                  << formatCell(user->getEmail(), 30) << " | "
-                  << user->getRole() << "\n";
-    }
-    std::cout << std::string(90, '-') << "\n";
-}
-
-bool LibrarySystem::searchBooks() {
-	std::system("clear");
-	printTitle();
-    std::string query;
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    
-    std::cout << "Search (Title/Author/Genre): "; 
-    std::getline(std::cin, query);
-
-    std::string queryLower = toLower(query);
-
-    bool found = false;
-    bool headerPrinted = false;
-
-    for (const auto& b : books) {
-        if (toLower(b.getId()).find(queryLower) != std::string::npos ||
-			toLower(b.getTitle()).find(queryLower) != std::string::npos ||
-            toLower(b.getAuthor()).find(queryLower) != std::string::npos ||
-            toLower(b.getGenre()).find(queryLower) != std::string::npos) {
-            
-            if (!headerPrinted) {
-				std::cout << "Search Results:\n";
-				printHeader();
-				headerPrinted = true;
-            }
-            printBookRow(b);
-            found = true;
-        }
+std::vector<Book> LibrarySystem::borrowedBy(const std::string& memberId) {
+    std::vector<Book> found;
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    std::vector<BookHandle> handles;
+    {
+        std::lock_guard<std::mutex> loansGuard(loansLock);
+        const std::vector<BookHandle>* loans = loansByMember.find(memberId);
+        if (loans) handles = *loans;
     }
-    if(headerPrinted) std::cout << std::string(110, '-') << "\n";
-    if (!found) std::cout << "No matching books found.\n";
-	return found;
+    for (BookHandle handle : handles) {
+        std::lock_guard<std::mutex> bookGuard(bookLock(handle));
+        const Book& book = books.get(handle);
+        // Returned since the list was copied
+        if (book.getIsBorrowed() && book.getBorrowedById() == memberId) found.push_back(book);
+    }
+    return found;
 }
 
-void LibrarySystem::borrowBook(Member* mem) {
-	std::system("clear");
-	printTitle();
-    std::cout << "\n--- Find a Book to Borrow ---\n";
-    
-    if (!searchBooks()) return;
+std::vector<HistoryEntry> LibrarySystem::historyOf(const std::string& memberId, time_t from, time_t to,
+                                                   size_t offset, size_t limit) {
+    std::vector<HistoryEntry> page;
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    Member* mem = asMember(findUser(memberId));
+    if (!mem) return page;
+    std::lock_guard<std::mutex> historyGuard(historyLock);
+    for (const HistoryEntry& entry : mem->getHistory().range(from, to).page(offset, limit)) page.push_back(entry);
+    return page;
+}
 
-    std::string bookId;
-    std::cout << "\n--- Enter Book ID ---\n";
-    std::cout << "Enter Book ID to borrow (or enter '0' to cancel): "; 
-    std::cin >> bookId;
+size_t LibrarySystem::historySize(const std::string& memberId) {
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    Member* mem = asMember(findUser(memberId));
+    if (!mem) return 0;
+    std::lock_guard<std::mutex> historyGuard(historyLock);
+    return mem->getHistory().size();
+}
 
-    if (bookId == "0") {
-        std::cout << "Borrowing cancelled.\n";
-        return;
+bool LibrarySystem::findBook(const std::string& id, Book& book) {
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    BookHandle handle = findBookHandle(id);
+    if (handle == INVALID_BOOK) return false;
+    std::lock_guard<std::mutex> bookGuard(bookLock(handle));
+    book = books.get(handle);
+    return true;
+}
+
+bool LibrarySystem::findUserInfo(const std::string& id, UserInfo& info) {
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    Person* user = findUser(id);
+    if (!user) return false;
+    info = UserInfo{user->getId(), user->getName(), user->getEmail(), user->role()};
+    return true;
+}
+
+std::vector<UserInfo> LibrarySystem::listUsers(size_t offset, size_t limit) {
+    std::vector<UserInfo> found;
+    size_t position = 0;
+    if (!versionsReady) {
+        // Snapshots are only kept once someone asks for one (see search)
+        std::shared_lock<std::shared_mutex> lock(stateLock);
+        auto take = [&](const Person* user) {
+            if (position++ >= offset && found.size() < limit)
+                found.push_back(UserInfo{user->getId(), user->getName(), user->getEmail(), user->role()});
+        };
+        for (const Librarian* l : users.librarians()) take(l);
+        for (const Member* m : users.members()) take(m);
+        return found;
+    }
+    CatalogueSnapshot view = snapshot();
+    for (Role role : {Role::Librarian, Role::Member}) {
+        view.forEachUser([&](const UserRecord& user) {
+            if (found.size() >= limit) return false;
+            if (user.role == role && position++ >= offset)
+                found.push_back(UserInfo{std::string(user.getId()), std::string(user.getName()),
+                                         std::string(user.getEmail()), user.role});
+            return true;
+        });
     }
+    return found;
+}
 
-    Book* book = findBook(bookId);
-    if (!book) {
-        std::cout << "[Error] Book does not exist.\n";
-        return;
+OpStatus LibrarySystem::borrow(const std::string& memberId, const std::string& bookId) {
+    ScopedTimer timer(Metrics::Op::Borrow);
+    {
+        std::shared_lock<std::shared_mutex> lock(stateLock);
+        Member* mem = asMember(findUser(memberId));
+        if (!mem) return OpStatus::NoSuchMember;
+        BookHandle handle = findBookHandle(bookId);
+        if (handle == INVALID_BOOK) return OpStatus::NoSuchBook;
+
+        std::lock_guard<std::mutex> bookGuard(bookLock(handle));
+        Book& book = books.get(handle);
+        if (book.getIsBorrowed()) return OpStatus::Unavailable;
+        checkOut(handle, memberId, 7);
+        recordHistory(mem, book.getTitle(), HistoryAction::Borrowed);
     }
+    Metrics::count(Metrics::Counter::Borrows);
+    commitOperation();
+    return OpStatus::Ok;
+}
 
-    if (book->getIsBorrowed()) {
-        std::cout << "Book is currently unavailable.\n";
-        char ch;
-        std::cout << "Do you want to reserve it? (y/n): ";
-        std::cin >> ch;
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-        
-        if (ch == 'y' || ch == 'Y') {
-            book->addReservation(mem->getId()); // todo
-            std::cout << "You have been added to the reservation queue.\n";
+OpStatus LibrarySystem::reserve(const std::string& memberId, const std::string& bookId) {
+    ScopedTimer timer(Metrics::Op::Reserve);
+    {
+        std::shared_lock<std::shared_mutex> lock(stateLock);
+        if (!asMember(findUser(memberId))) return OpStatus::NoSuchMember;
+        BookHandle handle = findBookHandle(bookId);
+        if (handle == INVALID_BOOK) return OpStatus::NoSuchBook;
+
+        {
+            // Only borrowed books take reservations. The queue itself is
+            // lock-free, so the book lock covers the check only
+            std::lock_guard<std::mutex> bookGuard(bookLock(handle));
+            if (!books.get(handle).getIsBorrowed()) return OpStatus::Unavailable;
+        }
+        reserveBook(handle, memberId);
+
+        // A return between the check and the push has already served the
+        // queue; take the reservation back rather than leave it on a book
+        // that is on the shelf
+        std::lock_guard<std::mutex> bookGuard(bookLock(handle));
+        Book& book = books.get(handle);
+        if (!book.getIsBorrowed() && book.removeReservation(memberId)) {
+            logOp("POPRES", {book.getId(), memberId});
+            return OpStatus::Unavailable;
         }
     }
-    else {
-        book->borrowBook(mem->getId(), 7); 
-        mem->addToHistory(book->getTitle(), "Borrowed");
-        std::cout << "Book borrowed successfully.\n";
+    Metrics::count(Metrics::Counter::Reservations);
+    commitOperation();
+    return OpStatus::Ok;
+}
+
+ReturnResult LibrarySystem::returnBook(const std::string& memberId, const std::string& bookId) {
+    ScopedTimer timer(Metrics::Op::Return);
+    ReturnResult result = {OpStatus::Ok, {false, 0, 0.0}};
+    {
+        std::shared_lock<std::shared_mutex> lock(stateLock);
+        Member* mem = asMember(findUser(memberId));
+        if (!mem) return {OpStatus::NoSuchMember, result.fine};
+        BookHandle handle = findBookHandle(bookId);
+        if (handle == INVALID_BOOK) return {OpStatus::NoSuchBook, result.fine};
+
+        std::lock_guard<std::mutex> bookGuard(bookLock(handle));
+        const Book& book = books.get(handle);
+        if (!book.getIsBorrowed() || book.getBorrowedById() != memberId) return {OpStatus::NotBorrower, result.fine};
+        result.fine = fineFor(book.getDueDate(), time(0));
+        returnAndHandOver(handle, mem);
     }
+    Metrics::count(Metrics::Counter::Returns);
+    if (result.fine.overdue) {
+        Metrics::count(Metrics::Counter::Fines);
+        Metrics::count(Metrics::Counter::FineCents, std::llround(result.fine.amount * 100));
+    }
+    commitOperation();
+    return result;
 }
 
-void LibrarySystem::returnBook(Member* mem) {
-	std::system("clear");
-	printTitle();
-    std::cout << "\n--- Return a Book ---\n";
+std::string LibrarySystem::addBook(const std::string& title, const std::string& author, const std::string& genre) {
+    std::string id;
+    {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        id = allocateBookId();
+        addToCatalogue(Book(id, title, author, genre, time(0)));
+    }
+    commitOperation();
+    return id;
+}
 
-    // Filter books borrowed by this specific member
-    std::vector<Book*> myBooks;
-    for (auto& b : books)
-        if (b.getBorrowedById() == mem->getId())
-            myBooks.push_back(&b);
+OpStatus LibrarySystem::removeBook(const std::string& bookId) {
+    {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        BookHandle handle = findBookHandle(bookId);
+        if (handle == INVALID_BOOK) return OpStatus::NoSuchBook;
+        removeFromCatalogue(handle);
+    }
+    commitOperation();
+    return OpStatus::Ok;
+}
 
-    if (myBooks.empty()) {
-        std::cout << "You currently have no borrowed books to return.\n";
-        return;
+OpStatus LibrarySystem::registerUser(Role role, const std::string& id, const std::string& name,
+                                     const std::string& email) {
+    {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        if (role == Role::Guest) return OpStatus::NotAllowed;
+        if (findUser(id)) return OpStatus::DuplicateId;
+        if (role == Role::Member) addUser(users.newMember(id, name, email));
+        else addUser(users.newLibrarian(id, name, email));
     }
-	displayBorrowedBooks(mem);
+    commitOperation();
+    return OpStatus::Ok;
+}
 
-    std::string bookId;
-    std::cout << "Enter Book ID to return (or enter '0' to cancel): "; 
-    std::cin >> bookId;
+OpStatus LibrarySystem::removeUser(const std::string& id) {
+    if (id == "admin") return OpStatus::NotAllowed; // the default account stays
+    {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        if (!eraseUser(id)) return OpStatus::NoSuchUser;
+    }
+    commitOperation();
+    return OpStatus::Ok;
+}
 
-    if (bookId == "0") {
-        std::cout << "Return cancelled.\n";
-        return;
+std::vector<Book> LibrarySystem::browse(Facet facet, const std::string& value, size_t offset, size_t limit) {
+    if (!facetsReady) {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        ensureFacets();
+    }
+    std::vector<Book> found;
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    // The lists only change under the exclusive lock
+    const std::vector<BookHandle>* handles = facets.books(facet, value);
+    if (!handles) return found;
+    for (size_t i = offset; i < handles->size() && i - offset < limit; i++) {
+        std::lock_guard<std::mutex> bookGuard(bookLock((*handles)[i]));
+        found.push_back(books.get((*handles)[i]));
     }
+    return found;
+}
 
-    Book* book = findBook(bookId);
-    if (!book) {
-        std::cout << "[Error] Invalid Book ID.\n"; 
-        return;
+std::vector<FacetCount> LibrarySystem::facetCounts(Facet facet) {
+    if (!facetsReady) {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        ensureFacets();
+    }
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    std::lock_guard<std::mutex> loansGuard(loansLock);
+    return facets.counts(facet);
+}
+
+bool LibrarySystem::facetCount(Facet facet, const std::string& value, FacetCount& count) {
+    if (!facetsReady) {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+        ensureFacets();
     }
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    std::lock_guard<std::mutex> loansGuard(loansLock);
+    return facets.count(facet, value, count);
+}
 
-    // Double check ownership (security)
-    if (book->getBorrowedById() != mem->getId()) {
-        std::cout << "[Error] You did not borrow this book (ID: " << bookId << ").\n"; 
-        return;
+OverdueReport LibrarySystem::overdueReport(time_t asOf) {
+    OverdueReport report = {asOf, {}, 0.0};
+    std::shared_lock<std::shared_mutex> lock(stateLock);
+    std::vector<DueLoan> due;
+    {
+        std::lock_guard<std::mutex> loansGuard(loansLock);
+        due = dueIndex.dueBefore(asOf);
     }
-    calculateFine(book->getDueDate());
-
-	// Give book to reserved person
-	if (book->hasReservations()) {
-		std::string nextUser = book->processNextReservation();
-		Member *tmp = dynamic_cast<Member*>(findUser(nextUser));
-		book->borrowBook(tmp->getId(), 7); 
-        mem->addToHistory(book->getTitle(), "Borrowed");
-	}
-	else
-	    book->returnBook();
-
-    mem->addToHistory(book->getTitle(), "Returned");
-    std::cout << "Book returned successfully.\n";
-}
-
-void LibrarySystem::displayBorrowedBooks(Member *mem) {
-	std::system("clear");
-	printTitle();
-	std::vector<Book*> myBooks;
-	for (auto& b : books) {
-		if (b.getBorrowedById() == mem->getId()) {
-			myBooks.push_back(&b);
-		}
-	}
-
-	if (myBooks.empty()) {
-		std::cout << "You currently have no borrowed books.\n\n";
-		return;
-	}
-
-	std::cout << "Your Borrowed Books:\n";
-	printHeader();
-	for (Book* b : myBooks) {
-		printBookRow(*b);
-	}
-	std::cout << std::string(110, '-') << "\n\n";
-}
-
-void LibrarySystem::displayHistory(Member *mem) {
-	std::system("clear");
-    std::cout << "=======================================\n";
-    std::cout << "   SMART LIBRARY MANAGEMENT SYSTEM     \n";
-    std::cout << "=======================================\n";
-
-    std::cout << "History for " << mem->getName() << ":\n";
-    if (mem->getHistory().empty()) {
-        std::cout << " - No history available.\n\n";
-        return;
+    report.loans.reserve(due.size());
+    for (const DueLoan& loan : due) {
+        std::lock_guard<std::mutex> bookGuard(bookLock(loan.book));
+        const Book& book = books.get(loan.book);
+        // Returned or renewed since the index was read
+        if (!book.getIsBorrowed() || book.getDueDate() != loan.due) continue;
+        Fine fine = fineFor(loan.due, asOf);
+        report.loans.push_back(OverdueLoan{std::string(book.getId()), std::string(book.getTitle()),
+                                           std::string(book.getBorrowedById()), loan.due, fine});
+        report.totalFines += fine.amount;
     }
+    return report;
+}
 
-    std::cout << std::string(60, '-') << "\n";
-    std::cout << formatCell("Date", 15) << " | "
-              << formatCell("Action", 10) << " | "
-              << "Book Title\n";
-    std::cout << std::string(60, '-') << "\n";
-
-    for (const auto& entry : mem->getHistory()) {
-        std::stringstream ss(entry);
-        std::string segment;
-        std::vector<std::string> parts;
-        
-        // Parse "Timestamp|Action|Title"
-        while(std::getline(ss, segment, '|')) {
-            parts.push_back(segment);
+namespace {
+
+// A field that would break the '|' and ',' delimited data files
+bool unsafeField(const std::string& field, bool isId) {
+    for (char c : field)
+        if (c == '|' || c == '\n' || (isId && c == ',')) return true;
+    return false;
+}
+
+// Loan state of a book as the batch will have left it so far
+struct PendingBook {
+    BookHandle handle = INVALID_BOOK; // INVALID_BOOK if added by the batch
+    bool borrowed = false;
+    std::string_view borrower;   // a batch field or an interned ID
+    size_t reservationsUsed = 0; // queue entries handed over by earlier returns
+};
+
+// What validation resolved for one item, so applying does not look it up again
+struct BatchTarget {
+    BookHandle handle = INVALID_BOOK;
+    Member* member = nullptr;
+};
+
+} // namespace
+
+BatchResult LibrarySystem::applyBatch(const std::vector<BatchOp>& ops) {
+    BatchResult result{false, 0, 0, 0, {}};
+    {
+        std::unique_lock<std::shared_mutex> lock(stateLock);
+
+        // Adds without an ID get the lowest free ones, like addBook, skipping
+        // IDs named by other adds in the batch. Everything taken here is
+        // handed back if the batch is rejected.
+        std::vector<std::string> reservedIds;
+        size_t adds = 0;
+        for (const BatchOp& op : ops) {
+            if (op.kind != BatchOpKind::AddBook) continue;
+            adds++;
+            if (!op.bookId.empty() && findBookHandle(op.bookId) == INVALID_BOOK) {
+                bookIds.take(op.bookId);
+                reservedIds.push_back(op.bookId);
+            }
         }
+        auto freeId = [&]() {
+            reservedIds.push_back(allocateBookId());
+            return reservedIds.back();
+        };
+
+        // Validate every item against the state the earlier items leave behind
+        HashIndex<PendingBook> pending;
+        pending.reserve(ops.size());
+        auto stateOf = [&](const std::string& id) -> PendingBook* {
+            if (PendingBook* p = pending.find(id)) return p;
+            BookHandle handle = findBookHandle(id);
+            if (handle == INVALID_BOOK) return nullptr;
+            const Book& b = books.get(handle);
+            PendingBook p;
+            p.handle = handle;
+            p.borrowed = b.getIsBorrowed();
+            p.borrower = b.getBorrowedById();
+            pending.insert(id, p);
+            return pending.find(id);
+        };
+        std::vector<BatchTarget> targets(ops.size());
+        std::vector<std::string> assignedIds; // for adds without an ID, in order
+        for (size_t i = 0; i < ops.size(); i++) {
+            const BatchOp& op = ops[i];
+            size_t line = op.line ? op.line : i + 1;
+            auto fail = [&](const char* reason) { result.errors.push_back(BatchError{line, reason}); };
+            if (op.kind == BatchOpKind::AddBook && op.bookId.empty()) assignedIds.push_back(freeId());
+            const std::string& id = op.kind == BatchOpKind::AddBook && op.bookId.empty() ? assignedIds.back() : op.bookId;
+
+            if (unsafeField(id, true) || unsafeField(op.memberId, true) || unsafeField(op.title, false) ||
+                unsafeField(op.author, false) || unsafeField(op.genre, false)) {
+                fail("fields may not contain '|' or line breaks, nor IDs ','");
+                continue;
+            }
+            if (op.kind == BatchOpKind::AddBook) {
+                if (op.title.empty()) fail("book has no title");
+                else if (stateOf(id)) fail("book ID already exists");
+                else pending.insert(id, PendingBook());
+                continue;
+            }
 
-        if (parts.size() >= 3) {
-            std::string dateStr = formatDate(std::stoll(parts[0]));
-            std::cout << formatCell(dateStr, 15) << " | "
-                      << formatCell(parts[1], 10) << " | "
-                      << parts[2] << "\n";
-        } else {
-            // Fallback for old data format
-            std::cout << entry << "\n"; 
+            PendingBook* book = stateOf(id);
+            if (!book) {
+                fail("no such book");
+                continue;
+            }
+            targets[i].handle = book->handle;
+            if (op.kind == BatchOpKind::Borrow) {
+                targets[i].member = asMember(findUser(op.memberId));
+                if (!targets[i].member) fail("no such member");
+                else if (book->borrowed) fail("book is already borrowed");
+                else {
+                    book->borrowed = true;
+                    book->borrower = op.memberId;
+                }
+            } else if (!book->borrowed) {
+                fail("book is not borrowed");
+            } else if (!op.memberId.empty() && op.memberId != book->borrower) {
+                fail("book is borrowed by another member");
+            } else {
+                targets[i].member = asMember(findUser(std::string(book->borrower)));
+                // Mirror returnAndHandOver: the first reservation with an account gets it
+                book->borrowed = false;
+                book->borrower = std::string_view();
+                if (book->handle == INVALID_BOOK) continue; // added by this batch, no queue
+                size_t position = 0;
+                for (std::string_view memberId : books.get(book->handle).getReservations()) {
+                    if (position++ < book->reservationsUsed) continue;
+                    book->reservationsUsed++;
+                    if (asMember(findUser(std::string(memberId)))) {
+                        book->borrowed = true;
+                        book->borrower = memberId;
+                        break;
+                    }
+                }
+            }
+        }
+        if (!result.errors.empty()) {
+            for (const std::string& id : reservedIds) bookIds.release(id);
+            return result;
         }
+
+        // Apply. Indexes are sized once up front and the search index is
+        // merged once at the end instead of re-sorting postings per book.
+        books.reserve(books.size() + adds);
+        bookIndex.reserve(bookIndex.size() + adds);
+        std::vector<BookHandle> added;
+        added.reserve(adds);
+        batching = true;
+        logOp("BATCH", {std::to_string(ops.size())});
+        size_t nextAssigned = 0;
+        for (size_t i = 0; i < ops.size(); i++) {
+            const BatchOp& op = ops[i];
+            if (op.kind == BatchOpKind::AddBook) {
+                const std::string& id = op.bookId.empty() ? assignedIds[nextAssigned++] : op.bookId;
+                added.push_back(storeBook(Book(id, op.title, op.author, op.genre, time(0))));
+                result.added++;
+                continue;
+            }
+            BookHandle handle = targets[i].handle;
+            if (handle == INVALID_BOOK) handle = findBookHandle(op.bookId); // added earlier in the batch
+            if (op.kind == BatchOpKind::Borrow) {
+                checkOut(handle, op.memberId, 7);
+                recordHistory(targets[i].member, books.get(handle).getTitle(), HistoryAction::Borrowed);
+                result.borrowed++;
+            } else {
+                returnAndHandOver(handle, targets[i].member);
+                result.returned++;
+            }
+        }
+        if (searchIndexReady) searchIndex.addAll(added);
+        logOp("COMMIT", {});
+        batching = false;
+        publishVersion();
+        result.applied = true;
     }
-    std::cout << std::string(60, '-') << "\n\n";
-}
\ No newline at end of file
+    commitOperation();
+    return result;
+}
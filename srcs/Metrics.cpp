@@ -0,0 +1,139 @@
+#include "Metrics.hpp"
+#include "OperationLog.hpp"
+#include <cstdio>
+#include <cmath>
+
+static const char* const OP_NAMES[] = {"load", "save", "search", "fuzzy_search", "find_book", "borrow", "return",
+                                       "reserve"};
+static const char* const COUNTER_NAMES[] = {"searches", "borrows",    "returns",           "reservations",
+                                            "fines",    "fine_cents", "search_cache_hits", "search_cache_misses"};
+
+const char* Metrics::opName(Op op) {
+    return OP_NAMES[static_cast<size_t>(op)];
+}
+
+const char* Metrics::counterName(Counter counter) {
+    return COUNTER_NAMES[static_cast<size_t>(counter)];
+}
+
+Metrics::Metrics() : on(true) {
+    reset();
+}
+
+Metrics& Metrics::global() {
+    static Metrics metrics;
+    return metrics;
+}
+
+size_t Metrics::bucketOf(uint64_t ns) {
+    if (ns < (uint64_t(1) << SUB_BITS)) return ns;
+    unsigned top = 63 - __builtin_clzll(ns);
+    if (top >= MAX_BITS) return BUCKETS - 1;
+    return (size_t(top - SUB_BITS + 1) << SUB_BITS) + ((ns >> (top - SUB_BITS)) & ((1u << SUB_BITS) - 1));
+}
+
+uint64_t Metrics::bucketLimit(size_t bucket) {
+    if (bucket < (size_t(1) << SUB_BITS)) return bucket;
+    unsigned shift = (bucket >> SUB_BITS) - 1;
+    uint64_t sub = bucket & ((1u << SUB_BITS) - 1);
+    return (((uint64_t(1) << SUB_BITS) + sub + 1) << shift) - 1;
+}
+
+Metrics::Summary Metrics::summary(Op op) const {
+    const Histogram& h = histograms[static_cast<size_t>(op)];
+    uint64_t counts[BUCKETS];
+    Summary s = {0, 0, 0, 0, 0, 0, 0};
+    for (size_t i = 0; i < BUCKETS; i++) {
+        counts[i] = h.buckets[i].load(std::memory_order_relaxed);
+        s.count += counts[i];
+    }
+    s.sumMs = h.sumNs.load(std::memory_order_relaxed) / 1e6;
+    if (s.count == 0) return s;
+
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    double* out[] = {&s.p50Ms, &s.p90Ms, &s.p99Ms, &s.p999Ms};
+    size_t q = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        if (!counts[i]) continue;
+        seen += counts[i];
+        while (q < 4 && seen >= quantiles[q] * s.count) *out[q++] = bucketLimit(i) / 1e6;
+        s.maxMs = bucketLimit(i) / 1e6;
+    }
+    return s;
+}
+
+uint64_t Metrics::value(Counter counter) const {
+    return counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+void Metrics::reset() {
+    for (Histogram& h : histograms) {
+        for (std::atomic<uint64_t>& b : h.buckets) b.store(0, std::memory_order_relaxed);
+        h.sumNs.store(0, std::memory_order_relaxed);
+    }
+    for (std::atomic<uint64_t>& c : counters) c.store(0, std::memory_order_relaxed);
+}
+
+std::string Metrics::text() const {
+    char line[160];
+    std::string out;
+    snprintf(line, sizeof(line), "%-19s %9s %10s %10s %10s %10s %10s %10s\n", "Operation", "Count", "Mean ms",
+             "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "Max ms");
+    out += line;
+    for (size_t i = 0; i < OP_COUNT; i++) {
+        Summary s = summary(static_cast<Op>(i));
+        snprintf(line, sizeof(line), "%-19s %9llu %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f\n", OP_NAMES[i],
+                 static_cast<unsigned long long>(s.count), s.count ? s.sumMs / s.count : 0.0, s.p50Ms, s.p90Ms,
+                 s.p99Ms, s.p999Ms, s.maxMs);
+        out += line;
+    }
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        Counter c = static_cast<Counter>(i);
+        if (c == Counter::FineCents) snprintf(line, sizeof(line), "%-19s %12.2f RM\n", "fine amount", value(c) / 100.0);
+        else snprintf(line, sizeof(line), "%-19s %9llu\n", COUNTER_NAMES[i], static_cast<unsigned long long>(value(c)));
+        out += line;
+    }
+    return out;
+}
+
+std::string Metrics::prometheus() const {
+    char line[160];
+    std::string out;
+    out += "# HELP library_operation_duration_seconds Time spent in library operations.\n";
+    out += "# TYPE library_operation_duration_seconds summary\n";
+    for (size_t i = 0; i < OP_COUNT; i++) {
+        Summary s = summary(static_cast<Op>(i));
+        const char* labels[] = {"0.5", "0.9", "0.99", "0.999"};
+        double values[] = {s.p50Ms, s.p90Ms, s.p99Ms, s.p999Ms};
+        for (size_t q = 0; q < 4; q++) {
+            // NaN is how Prometheus clients report a quantile with no samples
+            snprintf(line, sizeof(line), "library_operation_duration_seconds{op=\"%s\",quantile=\"%s\"} %.9g\n",
+                     OP_NAMES[i], labels[q], s.count ? values[q] / 1e3 : NAN);
+            out += line;
+        }
+        snprintf(line, sizeof(line), "library_operation_duration_seconds_sum{op=\"%s\"} %.9g\n", OP_NAMES[i],
+                 s.sumMs / 1e3);
+        out += line;
+        snprintf(line, sizeof(line), "library_operation_duration_seconds_count{op=\"%s\"} %llu\n", OP_NAMES[i],
+                 static_cast<unsigned long long>(s.count));
+        out += line;
+    }
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        Counter c = static_cast<Counter>(i);
+        if (c == Counter::FineCents) {
+            out += "# HELP library_fine_amount_total Late-return fines charged, in RM.\n";
+            out += "# TYPE library_fine_amount_total counter\n";
+            snprintf(line, sizeof(line), "library_fine_amount_total %.2f\n", value(c) / 100.0);
+        } else {
+            snprintf(line, sizeof(line), "# TYPE library_%s_total counter\nlibrary_%s_total %llu\n", COUNTER_NAMES[i],
+                     COUNTER_NAMES[i], static_cast<unsigned long long>(value(c)));
+        }
+        out += line;
+    }
+    return out;
+}
+
+bool Metrics::writePrometheus(const std::string& path) const {
+    return OperationLog::writeFileAtomic(path, prometheus());
+}
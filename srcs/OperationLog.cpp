@@ -0,0 +1,317 @@
+#include "OperationLog.hpp"
+#include "TextScanner.hpp"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct Crc32Table {
+    uint32_t entries[256];
+    Crc32Table() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+    }
+};
+
+static uint32_t crc32(const char* data, size_t length) {
+    static const Crc32Table table;
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++)
+        crc = table.entries[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0) return false;
+        data += n;
+        length -= n;
+    }
+    return true;
+}
+
+static bool fileExists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+// Makes renames, removals and new files in path's directory durable
+static bool syncDirectory(const std::string& path) {
+    size_t slash = path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int dirFd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd < 0) return false;
+    bool ok = fsync(dirFd) == 0;
+    ::close(dirFd);
+    return ok;
+}
+
+// Appends the whole of from to the end of to and fsyncs to
+static bool appendFile(const std::string& from, const std::string& to) {
+    int in = ::open(from.c_str(), O_RDONLY);
+    if (in < 0) return !fileExists(from);
+    int out = ::open(to.c_str(), O_WRONLY | O_APPEND);
+    bool ok = out >= 0;
+    char buffer[1 << 16];
+    ssize_t n;
+    while (ok && (n = ::read(in, buffer, sizeof(buffer))) != 0)
+        ok = n > 0 && writeAll(out, buffer, n);
+    ok = ok && fsync(out) == 0;
+    if (out >= 0) ::close(out);
+    ::close(in);
+    return ok;
+}
+
+OperationLog::OperationLog(const std::string& path, unsigned syncIntervalMs)
+    : path(path), rotatedPath(path + ".1"), syncIntervalMs(syncIntervalMs), fd(-1),
+      nextLsn(1), writtenLsn(0), durableLsn(0), sinceCheckpoint(0),
+      syncRequested(false), stopping(false), writeFailed(false), compacting(false), liveGoodBytes(0),
+      liveScanned(false) {}
+
+OperationLog::~OperationLog() {
+    waitForCompaction();
+    close();
+}
+
+bool OperationLog::open(uint64_t firstLsn) {
+    close();
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) return false;
+    struct stat st;
+    if (liveScanned && fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) > liveGoodBytes &&
+        (ftruncate(fd, liveGoodBytes) != 0 || fdatasync(fd) != 0)) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    nextLsn = firstLsn;
+    writtenLsn = durableLsn = firstLsn - 1;
+    stopping = false;
+    writeFailed = false;
+    flusher = std::thread(&OperationLog::flushLoop, this);
+    return true;
+}
+
+void OperationLog::stopFlusher() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    flushCv.notify_all();
+    if (flusher.joinable()) flusher.join();
+}
+
+void OperationLog::close() {
+    if (fd < 0) return;
+    stopFlusher();
+    fdatasync(fd);
+    ::close(fd);
+    fd = -1;
+}
+
+void OperationLog::flushLoop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        flushCv.wait_for(lock, std::chrono::milliseconds(syncIntervalMs),
+                         [this] { return stopping || syncRequested; });
+        // Cleared before the fsync, so a commit that asks while it runs
+        // gets the next one straight away instead of after the interval
+        syncRequested = false;
+        if (writtenLsn > durableLsn) {
+            // One fsync covers every record written since the last one
+            uint64_t target = writtenLsn;
+            int syncFd = dup(fd);
+            lock.unlock();
+            if (syncFd >= 0) {
+                fdatasync(syncFd);
+                ::close(syncFd);
+            }
+            lock.lock();
+            if (target > durableLsn) durableLsn = target;
+        }
+        durableCv.notify_all();
+        if (stopping) return;
+    }
+}
+
+uint64_t OperationLog::append(const std::string& op, std::initializer_list<std::string_view> fields) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (fd < 0 || writeFailed) return 0;
+    uint64_t lsn = nextLsn;
+
+    std::string line = std::to_string(lsn) + "|" + op;
+    for (const auto& field : fields) {
+        line += '|';
+        line += field;
+    }
+    char crc[16];
+    snprintf(crc, sizeof(crc), "|%08x\n", crc32(line.data(), line.size()));
+    line += crc;
+
+    if (!writeAll(fd, line.data(), line.size())) {
+        writeFailed = true;
+        return 0;
+    }
+    nextLsn++;
+    writtenLsn = lsn;
+    sinceCheckpoint++;
+    return lsn;
+}
+
+void OperationLog::sync() {
+    std::unique_lock<std::mutex> lock(mtx);
+    waitDurable(lock, writtenLsn);
+}
+
+void OperationLog::waitDurable(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mtx);
+    waitDurable(lock, lsn);
+}
+
+void OperationLog::waitDurable(std::unique_lock<std::mutex>& lock, uint64_t lsn) {
+    if (fd < 0) return;
+    // Never wait for a record this log has not written
+    uint64_t target = std::min(lsn, writtenLsn);
+    while (durableLsn < target && !stopping) {
+        syncRequested = true;
+        flushCv.notify_all();
+        durableCv.wait(lock);
+    }
+}
+
+uint64_t OperationLog::lastLsn() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return nextLsn - 1;
+}
+
+size_t OperationLog::recordsSinceCheckpoint() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return sinceCheckpoint;
+}
+
+bool OperationLog::compactionRunning() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return compacting;
+}
+
+uint64_t OperationLog::replay(const std::function<void(const LogRecord&)>& apply) {
+    uint64_t last = 0;
+    LogRecord record;
+    liveGoodBytes = 0;
+    liveScanned = true;
+    for (const std::string& file : {rotatedPath, path}) {
+        MappedFile in;
+        size_t good = 0;
+        if (!in.open(file)) {
+            if (file == path) liveScanned = false; // missing, or unreadable: leave it be
+            continue;
+        }
+        std::string_view text = in.view();
+        // Anything after the last newline is a torn final write
+        size_t complete = text.rfind('\n');
+        text = text.substr(0, complete == std::string_view::npos ? 0 : complete + 1);
+
+        LineReader lines(text);
+        std::string_view line;
+        while (lines.next(line)) {
+            size_t crcSep = line.rfind('|');
+            long long crc, lsn;
+            if (crcSep == std::string_view::npos || crcSep == 0 ||
+                std::from_chars(line.data() + crcSep + 1, line.data() + line.size(), crc, 16).ec != std::errc() ||
+                crc32(line.data(), crcSep) != static_cast<uint32_t>(crc))
+                break;
+
+            FieldSplitter fields(line.substr(0, crcSep), '|');
+            std::string_view segment;
+            fields.next(segment);
+            if (!parseInt(segment, lsn)) break;
+            record.lsn = static_cast<uint64_t>(lsn);
+            fields.next(segment);
+            record.op.assign(segment);
+            record.fields.clear();
+            while (fields.next(segment)) record.fields.emplace_back(segment);
+            if (line[crcSep - 1] == '|') record.fields.emplace_back(); // trailing empty field
+
+            apply(record);
+            if (record.lsn > last) last = record.lsn;
+            good = text.find('\n', line.data() - text.data() + line.size()) + 1;
+        }
+        if (file == path) liveGoodBytes = good;
+    }
+    return last;
+}
+
+bool OperationLog::rotate() {
+    // Caller holds mtx. Everything written so far moves to the rotated
+    // segment; later appends go to a fresh live log.
+    bool wasOpen = fd >= 0;
+    if (wasOpen) {
+        fdatasync(fd);
+        ::close(fd);
+        fd = -1;
+    }
+    bool ok = true;
+    if (!fileExists(rotatedPath)) {
+        ok = std::rename(path.c_str(), rotatedPath.c_str()) == 0 || !fileExists(path);
+    } else {
+        // A previous checkpoint failed; keep its records and add ours. The
+        // live log is only removed once the copy is on disk
+        ok = appendFile(path, rotatedPath);
+        if (ok) std::remove(path.c_str());
+    }
+    if (wasOpen) fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    // The rename or removal must be durable before a base that relies on it
+    ok = syncDirectory(path) && ok;
+    durableLsn = writtenLsn;
+    sinceCheckpoint = 0;
+    return ok && (!wasOpen || fd >= 0);
+}
+
+bool OperationLog::checkpoint(const std::function<bool()>& writeBase, bool async) {
+    if (!async) waitForCompaction();
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (compacting) return false;
+        if (!rotate()) writeFailed = true;
+        compacting = true;
+    }
+    if (compactor.joinable()) compactor.join();
+
+    auto run = [this, writeBase]() {
+        // Only drop the rotated records once the base holding them is durable
+        bool ok = writeBase();
+        if (ok) std::remove(rotatedPath.c_str());
+        std::lock_guard<std::mutex> lock(mtx);
+        compacting = false;
+        return ok;
+    };
+    if (!async) return run();
+    compactor = std::thread(run);
+    return true;
+}
+
+void OperationLog::waitForCompaction() {
+    if (compactor.joinable()) compactor.join();
+}
+
+bool OperationLog::writeFileAtomic(const std::string& path, const std::string& data) {
+    std::string tmpPath = path + ".tmp";
+    int out = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) return false;
+    bool ok = writeAll(out, data.data(), data.size()) && fsync(out) == 0;
+    ::close(out);
+    if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return syncDirectory(path);
+}
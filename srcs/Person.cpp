@@ -1,20 +1,24 @@
 #include "Person.hpp"
-#include <sstream>
-#include <vector>
+#include "StringPool.hpp"
+#include "TextScanner.hpp"
+#include <utility>
+
+std::string_view roleName(Role role) {
+    switch (role) {
+        case Role::Librarian: return "Librarian";
+        case Role::Member: return "Member";
+        case Role::Guest: return "Guest";
+    }
+    return "";
+}
 
 // --- Person ---
-Person::Person(std::string id, std::string name, std::string email) 
-    : id(id), name(name), email(email) {}
-
-std::string Person::getId() const { return id; }
-std::string Person::getName() const { return name; }
-std::string Person::getEmail() const { return email; }
+Person::Person(Role role, std::string id, std::string name, std::string email)
+    : id(std::move(id)), name(std::move(name)), email(std::move(email)), roleTag(role) {}
 
 // --- Librarian ---
 Librarian::Librarian(std::string id, std::string name, std::string email) 
-    : Person(id, name, email) {}
-
-std::string Librarian::getRole() const { return "Librarian"; }
+    : Person(Role::Librarian, std::move(id), std::move(name), std::move(email)) {}
 
 std::string Librarian::toFileString() const {
     return "Librarian|" + id + "|" + name + "|" + email;
@@ -22,38 +26,35 @@ std::string Librarian::toFileString() const {
 
 // --- Member ---
 Member::Member(std::string id, std::string name, std::string email) 
-    : Person(id, name, email) {}
-
-std::string Member::getRole() const { return "Member"; }
-std::list<std::string> Member::getHistory() const { return borrowingHistory; };
-
-void Member::addToHistory(std::string bookTitle, std::string action) {
-    std::stringstream ss;
-    ss << time(0) << "|" << action << "|" << bookTitle;
-    borrowingHistory.push_back(ss.str());
+    : Person(Role::Member, std::move(id), std::move(name), std::move(email)) {}
+const HistoryLog& Member::getHistory() const { return borrowingHistory; }
+
+HistoryEntry Member::addToHistory(std::string_view bookTitle, HistoryAction action) {
+    // Built from the arguments: an out-of-order time is sorted into place,
+    // so the last entry need not be this one
+    time_t now = time(0);
+    borrowingHistory.append(now, action, bookTitle);
+    StringPool& pool = StringPool::global();
+    return HistoryEntry{now, action, pool.view(pool.intern(bookTitle))};
 }
 
 std::string Member::toFileString() const {
-    std::stringstream ss;
-    ss << "Member|" << id << "|" << name << "|" << email << "|";
-    // Serialize linked list
-    for (auto it = borrowingHistory.begin(); it != borrowingHistory.end(); ++it) {
-        ss << *it;
-        if (std::next(it) != borrowingHistory.end()) ss << ",";
-    }
-    return ss.str();
+    std::string out = "Member|" + id + "|" + name + "|" + email + "|";
+    borrowingHistory.writeTo(out);
+    return out;
 }
 
-void Member::loadHistory(const std::string& historyStr) {
-    std::stringstream ss(historyStr);
-    std::string item;
-    while(std::getline(ss, item, ',')) {
-        if(!item.empty()) borrowingHistory.push_back(item);
+void Member::loadHistory(std::string_view historyStr) {
+    FieldSplitter entries(historyStr, ',');
+    std::string_view item;
+    while (entries.next(item)) {
+        if (!item.empty()) borrowingHistory.appendEntry(item);
     }
 }
 
-// --- Guest ---
-Guest::Guest() : Person("GUEST", "Guest User", "N/A") {}
+void Member::appendHistory(time_t time, HistoryAction action, std::string_view bookTitle) {
+    borrowingHistory.append(time, action, bookTitle);
+}
 
-std::string Guest::getRole() const { return "Guest"; }
-std::string Guest::toFileString() const { return ""; } // Guests are not saved
\ No newline at end of file
+// --- Guest ---
+Guest::Guest() : Person(Role::Guest, "GUEST", "Guest User", "N/A") {}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "ReservationQueue.hpp"
+
+ReservationQueue::ReservationQueue() : incoming(nullptr), head(nullptr), tail(nullptr) {}
+
+ReservationQueue::~ReservationQueue() {
+    destroy();
+}
+
+ReservationQueue::ReservationQueue(const ReservationQueue& other) : incoming(nullptr), head(nullptr), tail(nullptr) {
+    copyFrom(other);
+}
+
+ReservationQueue::ReservationQueue(ReservationQueue&& other) noexcept
+    : incoming(other.incoming.exchange(nullptr)), head(other.head), tail(other.tail) {
+    other.head = other.tail = nullptr;
+}
+
+ReservationQueue& ReservationQueue::operator=(const ReservationQueue& other) {
+    if (this != &other) {
+        destroy();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+ReservationQueue& ReservationQueue::operator=(ReservationQueue&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        incoming.store(other.incoming.exchange(nullptr));
+        head = other.head;
+        tail = other.tail;
+        other.head = other.tail = nullptr;
+    }
+    return *this;
+}
+
+void ReservationQueue::destroy() {
+    settle();
+    while (head) {
+        Node* next = head->next;
+        delete head;
+        head = next;
+    }
+    tail = nullptr;
+}
+
+void ReservationQueue::copyFrom(const ReservationQueue& other) {
+    other.settle();
+    for (const Node* from = other.head; from; from = from->next) {
+        Node* node = new Node{from->memberId, nullptr};
+        if (tail) tail->next = node;
+        else head = node;
+        tail = node;
+    }
+}
+
+void ReservationQueue::push(std::string_view memberId) {
+    Node* node = new Node{StringPool::global().intern(memberId), incoming.load(std::memory_order_relaxed)};
+    // Only the consumer removes nodes, and it takes the whole stack at once,
+    // so a plain CAS loop is ABA-safe here
+    while (!incoming.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                           std::memory_order_relaxed)) {}
+}
+
+void ReservationQueue::settle() const {
+    Node* batch = incoming.exchange(nullptr, std::memory_order_acquire);
+    if (!batch) return;
+    // Reverse newest-first into oldest-first and append to the FIFO
+    Node* first = nullptr;
+    Node* last = batch;
+    while (batch) {
+        Node* next = batch->next;
+        batch->next = first;
+        first = batch;
+        batch = next;
+    }
+    if (tail) tail->next = first;
+    else head = first;
+    tail = last;
+}
+
+bool ReservationQueue::pop(std::string& memberId) {
+    if (!head) settle();
+    if (!head) return false;
+    Node* node = head;
+    head = node->next;
+    if (!head) tail = nullptr;
+    memberId = StringPool::global().view(node->memberId);
+    delete node;
+    return true;
+}
+
+bool ReservationQueue::remove(std::string_view memberId) {
+    settle();
+    Node* prev = nullptr;
+    for (Node* node = head; node; prev = node, node = node->next) {
+        if (StringPool::global().view(node->memberId) != memberId) continue;
+        (prev ? prev->next : head) = node->next;
+        if (tail == node) tail = prev;
+        delete node;
+        return true;
+    }
+    return false;
+}
+
+bool ReservationQueue::empty() const {
+    return !head && !incoming.load(std::memory_order_acquire);
+}
+
+size_t ReservationQueue::size() const {
+    size_t count = 0;
+    for (auto it = begin(); it != end(); ++it) count++;
+    return count;
+}
+
+void ReservationQueue::clear() {
+    destroy();
+}
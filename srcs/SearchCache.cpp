@@ -0,0 +1,116 @@
+#include "SearchCache.hpp"
+#include <algorithm>
+
+SearchCache::SearchCache(size_t capacityBytes)
+    : bytes(0), capacity(capacityBytes), hits(0), misses(0), invalidations(0), evictions(0) {}
+
+std::string SearchCache::normalize(std::vector<std::string>& terms) {
+    std::sort(terms.begin(), terms.end());
+    std::string key;
+    for (const std::string& term : terms) {
+        if (!key.empty()) key += ' ';
+        key += term;
+    }
+    return key;
+}
+
+const std::string& SearchCache::indexTerm(const Entry& entry) {
+    // The longest word has the fewest books whose words it prefixes
+    return *std::max_element(entry.terms.begin(), entry.terms.end(),
+                             [](const std::string& a, const std::string& b) { return a.size() < b.size(); });
+}
+
+void SearchCache::drop(std::list<Entry>::iterator it) {
+    const std::string& term = indexTerm(*it);
+    std::vector<Entry*>* entries = byTerm.find(term);
+    if (entries) {
+        entries->erase(std::find(entries->begin(), entries->end(), &*it));
+        if (entries->empty()) byTerm.erase(term);
+    }
+    byKey.erase(it->key);
+    bytes -= it->bytes;
+    lru.erase(it);
+}
+
+SearchCache::Results SearchCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::list<Entry>::iterator* it = byKey.find(key);
+    if (!it) {
+        misses++;
+        return Results();
+    }
+    hits++;
+    lru.splice(lru.begin(), lru, *it);
+    return (*it)->books;
+}
+
+void SearchCache::insert(const std::string& key, const std::vector<std::string>& terms, Results books) {
+    // Rough heap footprint: the node, key and words, and the handles
+    size_t size = sizeof(Entry) + 64 + key.size() * 2 + terms.size() * sizeof(std::string) +
+                  books->size() * sizeof(BookHandle);
+    std::lock_guard<std::mutex> lock(mtx);
+    if (terms.empty() || size > capacity / 4 || byKey.contains(key)) return;
+    lru.push_front(Entry{key, terms, std::move(books), size});
+    byKey.insert(key, lru.begin());
+    const std::string& term = indexTerm(lru.front());
+    std::vector<Entry*>* entries = byTerm.find(term);
+    if (entries) entries->push_back(&lru.front());
+    else byTerm.insert(term, std::vector<Entry*>(1, &lru.front()));
+    bytes += size;
+    while (bytes > capacity) {
+        drop(std::prev(lru.end()));
+        evictions++;
+    }
+}
+
+// True if term is a prefix of one of the sorted words
+static bool prefixesAny(const std::vector<std::string>& words, const std::string& term) {
+    auto it = std::lower_bound(words.begin(), words.end(), term);
+    return it != words.end() && it->compare(0, term.size(), term) == 0;
+}
+
+void SearchCache::invalidate(const std::vector<std::string>& bookTerms) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (lru.empty()) return;
+    // Entries indexed under a prefix of one of the book's words
+    std::vector<Entry*> candidates;
+    std::string prefix;
+    for (const std::string& word : bookTerms) {
+        for (size_t length = 1; length <= word.size(); length++) {
+            prefix.assign(word, 0, length);
+            const std::vector<Entry*>* entries = byTerm.find(prefix);
+            if (entries) candidates.insert(candidates.end(), entries->begin(), entries->end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    for (Entry* entry : candidates) {
+        bool matches = std::all_of(entry->terms.begin(), entry->terms.end(),
+                                   [&](const std::string& term) { return prefixesAny(bookTerms, term); });
+        if (!matches) continue;
+        drop(*byKey.find(entry->key));
+        invalidations++;
+    }
+}
+
+void SearchCache::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    lru.clear();
+    byKey.clear();
+    byTerm.clear();
+    bytes = 0;
+}
+
+void SearchCache::setCapacity(size_t capacityBytes) {
+    std::lock_guard<std::mutex> lock(mtx);
+    capacity = capacityBytes;
+    while (bytes > capacity) {
+        drop(std::prev(lru.end()));
+        evictions++;
+    }
+}
+
+SearchCacheStats SearchCache::stats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return SearchCacheStats{hits, misses, invalidations, evictions, lru.size(), bytes, capacity};
+}
@@ -0,0 +1,191 @@
+#include "SearchIndex.hpp"
+#include <algorithm>
+#include <cctype>
+
+static bool isWordChar(unsigned char c) {
+    // Bytes >= 0x80 keep UTF-8 sequences inside a single word
+    return std::isalnum(c) || c >= 0x80;
+}
+
+std::vector<std::string> SearchIndex::tokenize(std::string_view text) {
+    std::vector<std::string> tokens;
+    std::string current;
+    for (unsigned char c : text) {
+        if (isWordChar(c)) {
+            current += static_cast<char>(std::tolower(c));
+        } else if (!current.empty()) {
+            tokens.push_back(current);
+            current.clear();
+        }
+    }
+    if (!current.empty()) tokens.push_back(current);
+    return tokens;
+}
+
+void SearchIndex::collectTerms(const Book& book, std::vector<std::string>& terms) {
+    for (std::string_view field : {book.getId(), book.getTitle(), book.getAuthor(), book.getGenre()}) {
+        std::vector<std::string> tokens = tokenize(field);
+        terms.insert(terms.end(), tokens.begin(), tokens.end());
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+}
+
+// Scores a word-prefix match of term (already lowercase) inside text:
+// 0 = no match, 1 = prefix of a word, 2 = whole word
+static int matchWord(std::string_view text, const std::string& term) {
+    int best = 0;
+    size_t n = text.size(), m = term.size();
+    for (size_t i = 0; i + m <= n; i++) {
+        if (!isWordChar(text[i]) || (i > 0 && isWordChar(text[i - 1]))) continue;
+        size_t k = 0;
+        while (k < m && std::tolower(static_cast<unsigned char>(text[i + k])) == term[k]) k++;
+        if (k < m) continue;
+        if (i + m == n || !isWordChar(text[i + m])) return 2;
+        best = 1;
+    }
+    return best;
+}
+
+int SearchIndex::scoreTerm(const Book& book, const std::string& term) {
+    // Weighted by field: ID > title > author > genre
+    int score = 0;
+    int m;
+    if ((m = matchWord(book.getId(), term))) score += 4 * m;
+    if ((m = matchWord(book.getTitle(), term))) score += 3 + m;
+    if ((m = matchWord(book.getAuthor(), term))) score += 2 + m;
+    if ((m = matchWord(book.getGenre(), term))) score += 1 + m;
+    return score;
+}
+
+SearchIndex::SearchIndex(const BookStore& books) : books(books) {}
+
+void SearchIndex::add(BookHandle handle) {
+    std::vector<std::string> terms;
+    collectTerms(books.get(handle), terms);
+    for (const auto& term : terms) {
+        std::vector<BookHandle>& docs = postings[term];
+        docs.insert(std::lower_bound(docs.begin(), docs.end(), handle), handle);
+    }
+}
+
+void SearchIndex::addAll(const std::vector<BookHandle>& handles) {
+    // Append to each posting list, then restore its order once: one sort of
+    // the new tail and one merge per touched term instead of an insert per book
+    std::map<std::vector<BookHandle>*, size_t> touched; // list -> size before
+    std::vector<std::string> terms;
+    for (BookHandle handle : handles) {
+        terms.clear();
+        collectTerms(books.get(handle), terms);
+        for (const auto& term : terms) {
+            std::vector<BookHandle>& docs = postings[term];
+            touched.emplace(&docs, docs.size());
+            docs.push_back(handle);
+        }
+    }
+    for (const auto& entry : touched) {
+        std::vector<BookHandle>& docs = *entry.first;
+        auto middle = docs.begin() + entry.second;
+        std::sort(middle, docs.end());
+        std::inplace_merge(docs.begin(), middle, docs.end());
+    }
+}
+
+void SearchIndex::remove(BookHandle handle) {
+    std::vector<std::string> terms;
+    collectTerms(books.get(handle), terms);
+    for (const auto& term : terms) {
+        auto it = postings.find(term);
+        if (it == postings.end()) continue;
+        std::vector<BookHandle>& docs = it->second;
+        auto pos = std::lower_bound(docs.begin(), docs.end(), handle);
+        if (pos != docs.end() && *pos == handle) docs.erase(pos);
+        if (docs.empty()) postings.erase(it);
+    }
+}
+
+void SearchIndex::clear() {
+    postings.clear();
+}
+
+size_t SearchIndex::termCount() const {
+    return postings.size();
+}
+
+static bool idLess(std::string_view a, std::string_view b) {
+    // Numeric IDs sort naturally when compared by length first
+    if (a.size() != b.size()) return a.size() < b.size();
+    return a < b;
+}
+
+std::vector<SearchResult> SearchIndex::search(const std::string& query) const {
+    std::vector<SearchResult> results;
+    std::vector<std::string> terms = tokenize(query);
+    if (terms.empty()) return results;
+
+    // Pick the term whose prefix range has the fewest postings to seed candidates
+    size_t seed = 0;
+    size_t seedCost = static_cast<size_t>(-1);
+    for (size_t t = 0; t < terms.size(); t++) {
+        size_t cost = 0;
+        for (auto it = postings.lower_bound(terms[t]);
+             it != postings.end() && it->first.compare(0, terms[t].size(), terms[t]) == 0; ++it) {
+            cost += it->second.size();
+            if (cost >= seedCost) break;
+        }
+        if (cost == 0) return results; // AND can never match
+        if (cost < seedCost) {
+            seedCost = cost;
+            seed = t;
+        }
+    }
+
+    std::vector<BookHandle> candidates;
+    candidates.reserve(seedCost);
+    for (auto it = postings.lower_bound(terms[seed]);
+         it != postings.end() && it->first.compare(0, terms[seed].size(), terms[seed]) == 0; ++it) {
+        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Narrow candidates through the other terms' postings while their prefix
+    // range is small; anything left is checked against the fields when scoring
+    for (size_t t = 0; t < terms.size() && !candidates.empty(); t++) {
+        if (t == seed) continue;
+        std::vector<const std::vector<BookHandle>*> lists;
+        for (auto it = postings.lower_bound(terms[t]);
+             it != postings.end() && it->first.compare(0, terms[t].size(), terms[t]) == 0; ++it) {
+            lists.push_back(&it->second);
+            if (lists.size() > 16) break;
+        }
+        if (lists.size() > 16) continue;
+        auto missing = [&lists](BookHandle book) {
+            for (const auto* docs : lists) {
+                if (std::binary_search(docs->begin(), docs->end(), book)) return false;
+            }
+            return true;
+        };
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), missing), candidates.end());
+    }
+
+    // Score every term against the surviving candidates' fields
+    for (BookHandle book : candidates) {
+        int total = 0;
+        for (const auto& term : terms) {
+            int s = scoreTerm(books.get(book), term);
+            if (s == 0) {
+                total = 0;
+                break;
+            }
+            total += s;
+        }
+        if (total > 0) results.push_back({book, total});
+    }
+
+    std::sort(results.begin(), results.end(), [this](const SearchResult& a, const SearchResult& b) {
+        if (a.score != b.score) return a.score > b.score;
+        return idLess(books.get(a.book).getId(), books.get(b.book).getId());
+    });
+    return results;
+}
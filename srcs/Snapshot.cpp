@@ -0,0 +1,220 @@
+#include "Snapshot.hpp"
+#include "OperationLog.hpp"
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char SNAPSHOT_MAGIC[8] = {'S', 'L', 'I', 'B', 'S', 'N', 'A', 'P'};
+static const uint32_t ENDIAN_TAG = 0x01020304;
+
+/* Writer */
+namespace {
+
+// Deduplicating string heap; authors, genres and borrower IDs repeat a lot
+class StringHeap {
+private:
+    std::string data;
+    std::unordered_map<std::string, SnapString> seen;
+
+public:
+    bool overflow = false;
+
+    SnapString add(std::string_view view) {
+        std::string s(view);
+        auto it = seen.find(s);
+        if (it != seen.end()) return it->second;
+        if (data.size() + s.size() > UINT32_MAX) {
+            overflow = true;
+            return SnapString{0, 0};
+        }
+        SnapString ref{static_cast<uint32_t>(data.size()), static_cast<uint32_t>(s.size())};
+        data += s;
+        seen.emplace(s, ref);
+        return ref;
+    }
+    const std::string& bytes() const { return data; }
+};
+
+uint64_t align8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+void appendSection(std::string& out, const void* data, size_t bytes) {
+    out.append(static_cast<const char*>(data), bytes);
+    out.append(align8(bytes) - bytes, '\0');
+}
+
+} // namespace
+
+std::string buildSnapshot(const BookStore& books, const UserStore& users, uint64_t logSequence) {
+    StringHeap heap;
+    std::vector<SnapBook> bookRecords;
+    std::vector<SnapUser> userRecords;
+    std::vector<SnapString> reservations;
+    std::vector<SnapHistory> history;
+    bookRecords.reserve(books.size());
+
+    for (const Book& b : books) {
+        SnapBook r;
+        std::memset(&r, 0, sizeof(r));
+        r.id = heap.add(b.getId());
+        r.title = heap.add(b.getTitle());
+        r.author = heap.add(b.getAuthor());
+        r.genre = heap.add(b.getGenre());
+        r.borrower = heap.add(b.getBorrowedById());
+        r.dueDate = static_cast<int64_t>(b.getDueDate());
+        r.borrowed = b.getIsBorrowed();
+        r.reservationBegin = static_cast<uint32_t>(reservations.size());
+        for (const auto& memberId : b.getReservations()) reservations.push_back(heap.add(memberId));
+        r.reservationCount = static_cast<uint32_t>(reservations.size()) - r.reservationBegin;
+        bookRecords.push_back(r);
+    }
+
+    auto addUser = [&](const Person* p, uint32_t role) -> SnapUser& {
+        SnapUser r;
+        std::memset(&r, 0, sizeof(r));
+        r.id = heap.add(p->getId());
+        r.name = heap.add(p->getName());
+        r.email = heap.add(p->getEmail());
+        r.role = role;
+        r.historyBegin = static_cast<uint32_t>(history.size());
+        userRecords.push_back(r);
+        return userRecords.back();
+    };
+    for (const Librarian* l : users.librarians()) addUser(l, SNAP_LIBRARIAN);
+    for (const Member* m : users.members()) {
+        SnapUser& r = addUser(m, SNAP_MEMBER);
+        for (const HistoryEntry& entry : m->getHistory().all()) {
+            SnapHistory h;
+            std::memset(&h, 0, sizeof(h));
+            h.time = static_cast<int64_t>(entry.time);
+            h.title = heap.add(entry.title);
+            h.action = static_cast<uint32_t>(entry.action);
+            history.push_back(h);
+        }
+        const HistoryLog& log = m->getHistory();
+        for (size_t i = 0; i < log.unparsedCount(); i++) {
+            SnapHistory h;
+            std::memset(&h, 0, sizeof(h));
+            h.title = heap.add(log.unparsedEntry(i));
+            h.action = SNAP_HISTORY_UNPARSED;
+            history.push_back(h);
+        }
+        r.historyCount = static_cast<uint32_t>(history.size()) - r.historyBegin;
+    }
+    if (heap.overflow) return std::string();
+
+    SnapHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.endianTag = ENDIAN_TAG;
+    uint64_t offset = align8(sizeof(SnapHeader));
+    auto place = [&offset](uint64_t& where, uint64_t bytes) {
+        where = offset;
+        offset += align8(bytes);
+    };
+    h.bookCount = bookRecords.size();
+    place(h.booksOffset, bookRecords.size() * sizeof(SnapBook));
+    h.userCount = userRecords.size();
+    place(h.usersOffset, userRecords.size() * sizeof(SnapUser));
+    h.reservationCount = reservations.size();
+    place(h.reservationsOffset, reservations.size() * sizeof(SnapString));
+    h.historyCount = history.size();
+    place(h.historyOffset, history.size() * sizeof(SnapHistory));
+    h.stringsSize = heap.bytes().size();
+    place(h.stringsOffset, heap.bytes().size());
+    h.fileSize = offset;
+    h.logSequence = logSequence;
+
+    std::string out;
+    out.reserve(offset);
+    appendSection(out, &h, sizeof(h));
+    appendSection(out, bookRecords.data(), bookRecords.size() * sizeof(SnapBook));
+    appendSection(out, userRecords.data(), userRecords.size() * sizeof(SnapUser));
+    appendSection(out, reservations.data(), reservations.size() * sizeof(SnapString));
+    appendSection(out, history.data(), history.size() * sizeof(SnapHistory));
+    appendSection(out, heap.bytes().data(), heap.bytes().size());
+    return out;
+}
+
+bool writeSnapshot(const std::string& path, const BookStore& books, const UserStore& users,
+                   uint64_t logSequence) {
+    std::string data = buildSnapshot(books, users, logSequence);
+    return !data.empty() && OperationLog::writeFileAtomic(path, data);
+}
+
+/* Reader */
+SnapshotView::SnapshotView() : base(nullptr), length(0), header(nullptr) {}
+
+SnapshotView::~SnapshotView() {
+    close();
+}
+
+void SnapshotView::close() {
+    if (base) munmap(const_cast<char*>(base), length);
+    base = nullptr;
+    length = 0;
+    header = nullptr;
+}
+
+bool SnapshotView::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) return false;
+    base = static_cast<const char*>(mapped);
+    length = st.st_size;
+
+    const SnapHeader* h = reinterpret_cast<const SnapHeader*>(base);
+    auto fits = [this](uint64_t offset, uint64_t count, uint64_t size) {
+        return offset <= length && count <= (length - offset) / size;
+    };
+    bool valid = std::memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) == 0 &&
+                 h->version >= SNAPSHOT_MIN_VERSION && h->version <= SNAPSHOT_VERSION &&
+                 h->endianTag == ENDIAN_TAG &&
+                 h->fileSize == length &&
+                 fits(h->booksOffset, h->bookCount, sizeof(SnapBook)) &&
+                 fits(h->usersOffset, h->userCount, sizeof(SnapUser)) &&
+                 fits(h->reservationsOffset, h->reservationCount, sizeof(SnapString)) &&
+                 fits(h->historyOffset, h->historyCount, h->version >= 3 ? sizeof(SnapHistory) : sizeof(SnapString)) &&
+                 fits(h->stringsOffset, h->stringsSize, 1);
+    header = h;
+    if (!valid || !recordsFit()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotView::recordsFit() const {
+    // Every reservation and history range must stay inside its section, so
+    // reservation() and history() can index without checks
+    for (size_t i = 0; i < header->bookCount; i++) {
+        const SnapBook& r = book(i);
+        if (r.reservationBegin > header->reservationCount ||
+            r.reservationCount > header->reservationCount - r.reservationBegin)
+            return false;
+    }
+    for (size_t i = 0; i < header->userCount; i++) {
+        const SnapUser& r = user(i);
+        if (r.historyBegin > header->historyCount || r.historyCount > header->historyCount - r.historyBegin)
+            return false;
+    }
+    return true;
+}
+
+std::string_view SnapshotView::str(const SnapString& s) const {
+    // Out-of-range references from a damaged file read as empty
+    if (s.offset > header->stringsSize || s.length > header->stringsSize - s.offset) return std::string_view();
+    return std::string_view(base + header->stringsOffset + s.offset, s.length);
+}
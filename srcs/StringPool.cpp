@@ -0,0 +1,107 @@
+#include "StringPool.hpp"
+#include "HashIndex.hpp"
+#include <cstring>
+#include <stdexcept>
+
+static const StringPool::Handle EMPTY_SLOT = UINT32_MAX;
+
+StringPool::StringPool() {
+    for (Shard& shard : shards) {
+        shard.chunks.reset(new std::atomic<Entry*>[MAX_CHUNKS]());
+        shard.slots.assign(256, EMPTY_SLOT);
+    }
+    // Handle 0 (shard 0, index 0) is the empty string; intern() never hashes it
+    Shard& first = shards[0];
+    first.ownedChunks.emplace_back(new Entry[1u << CHUNK_BITS]);
+    first.ownedChunks.back()[0] = Entry{"", 0};
+    first.chunks[0].store(first.ownedChunks.back().get(), std::memory_order_release);
+    first.count = 1;
+}
+
+StringPool& StringPool::global() {
+    static StringPool pool;
+    return pool;
+}
+
+const char* StringPool::store(Shard& shard, std::string_view s) {
+    if (s.empty()) return "";
+    shard.totalBytes += s.size();
+    char* p;
+    if (s.size() > BLOCK_BYTES / 4) {
+        // Long strings get a block of their own instead of wasting the current one's tail
+        shard.blocks.emplace_back(new char[s.size()]);
+        p = shard.blocks.back().get();
+    } else {
+        if (shard.blockUsed + s.size() > BLOCK_BYTES) {
+            shard.blocks.emplace_back(new char[BLOCK_BYTES]);
+            shard.block = shard.blocks.back().get();
+            shard.blockUsed = 0;
+        }
+        p = shard.block + shard.blockUsed;
+        shard.blockUsed += s.size();
+    }
+    std::memcpy(p, s.data(), s.size());
+    return p;
+}
+
+void StringPool::grow(Shard& shard) {
+    std::vector<Handle> old(shard.slots.size() * 2, EMPTY_SLOT);
+    old.swap(shard.slots);
+    size_t mask = shard.slots.size() - 1;
+    for (Handle h : old) {
+        if (h == EMPTY_SLOT) continue;
+        std::string_view s = view(h);
+        size_t i = (hashId(s.data(), s.size()) >> SHARD_BITS) & mask;
+        while (shard.slots[i] != EMPTY_SLOT) i = (i + 1) & mask;
+        shard.slots[i] = h;
+    }
+}
+
+StringPool::Handle StringPool::intern(std::string_view s) {
+    if (s.empty()) return 0;
+    uint32_t hash = hashId(s.data(), s.size());
+    uint32_t shardIndex = hash & ((1u << SHARD_BITS) - 1);
+    Shard& shard = shards[shardIndex];
+    std::lock_guard<std::mutex> lock(shard.mtx);
+
+    size_t mask = shard.slots.size() - 1;
+    size_t i = (hash >> SHARD_BITS) & mask;
+    for (; shard.slots[i] != EMPTY_SLOT; i = (i + 1) & mask) {
+        if (view(shard.slots[i]) == s) return shard.slots[i];
+    }
+
+    if (shard.count == MAX_CHUNKS << CHUNK_BITS) throw std::length_error("StringPool is full");
+    uint32_t index = shard.count;
+    size_t chunk = index >> CHUNK_BITS;
+    if (!shard.chunks[chunk].load(std::memory_order_relaxed)) {
+        shard.ownedChunks.emplace_back(new Entry[1u << CHUNK_BITS]);
+        shard.chunks[chunk].store(shard.ownedChunks.back().get(), std::memory_order_release);
+    }
+    shard.chunks[chunk].load(std::memory_order_relaxed)[index & ((1u << CHUNK_BITS) - 1)] =
+        Entry{store(shard, s), static_cast<uint32_t>(s.size())};
+    shard.count++;
+
+    Handle handle = (index << SHARD_BITS) | shardIndex;
+    shard.slots[i] = handle;
+    if (shard.count * 2 > shard.slots.size()) grow(shard);
+    return handle;
+}
+
+size_t StringPool::size() {
+    size_t total = 0;
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        total += shard.count;
+    }
+    return total;
+}
+
+size_t StringPool::bytes() {
+    size_t total = 0;
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        total += shard.totalBytes + shard.ownedChunks.size() * (sizeof(Entry) << CHUNK_BITS) +
+                 shard.slots.size() * sizeof(Handle);
+    }
+    return total;
+}
@@ -0,0 +1,169 @@
+#include "TableWriter.hpp"
+#include <charconv>
+#include <climits>
+#include <cstdio>
+#include <algorithm>
+
+bool parseTableFormat(std::string_view name, TableFormat& format) {
+    if (name == "text") format = TableFormat::Text;
+    else if (name == "tsv") format = TableFormat::Tsv;
+    else if (name == "json") format = TableFormat::Json;
+    else return false;
+    return true;
+}
+
+/* DateCache */
+DateCache::DateCache(const char* pattern) : slots(SLOTS, Slot{LLONG_MIN, 0, {}}), pattern(pattern) {}
+
+std::string_view DateCache::format(time_t t) {
+    long long quarter = t >= 0 ? t / 900 : -((899 - (long long)t) / 900);
+    Slot& slot = slots[static_cast<unsigned long long>(quarter) % SLOTS];
+    if (slot.quarter != quarter) {
+        struct tm timeInfo;
+        size_t length = 0;
+        if (localtime_r(&t, &timeInfo)) length = strftime(slot.text, sizeof(slot.text), pattern, &timeInfo);
+        if (length == 0) {
+            std::string_view unknown = "Unknown";
+            unknown.copy(slot.text, unknown.size());
+            length = unknown.size();
+        }
+        slot.quarter = quarter;
+        slot.length = static_cast<unsigned char>(length);
+    }
+    return std::string_view(slot.text, slot.length);
+}
+
+/* TableWriter */
+TableWriter::TableWriter(std::ostream& out, TableFormat format, std::vector<TableColumn> columns, size_t ruleWidth)
+    : out(out), format(format), columns(std::move(columns)), ruleWidth(ruleWidth), column(0), rows(0),
+      finished(false), dates(format == TableFormat::Text ? "%b %d %Y" : "%Y-%m-%d") {
+    buf.reserve(FLUSH_AT + 4096);
+    if (format == TableFormat::Json) {
+        buf += "[\n";
+        return;
+    }
+    if (format == TableFormat::Text) rule();
+    for (const TableColumn& c : this->columns) cell(c.key && format == TableFormat::Tsv ? c.key : c.name);
+    column = 0;
+    buf += '\n';
+    if (format == TableFormat::Text) rule();
+}
+
+TableWriter::~TableWriter() {
+    if (!finished) finish();
+}
+
+void TableWriter::rule() {
+    buf.append(ruleWidth, '-');
+    buf += '\n';
+}
+
+void TableWriter::startCell() {
+    if (format == TableFormat::Json) {
+        if (column == 0) buf += rows ? ",\n{" : "{";
+        else buf += ',';
+        buf += '"';
+        buf += columns[column].key ? columns[column].key : columns[column].name;
+        buf += "\":";
+    } else if (column > 0) {
+        buf += format == TableFormat::Text ? " | " : "\t";
+    }
+}
+
+// Copies text, escaped for the format, in runs between special characters
+void TableWriter::append(std::string_view text) {
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = text[i];
+        bool special = format == TableFormat::Json ? (c < 0x20 || c == '"' || c == '\\')
+                                                   : (c == '\t' || c == '\n' || c == '\r');
+        if (!special) continue;
+        buf.append(text.data() + run, i - run);
+        run = i + 1;
+        if (format == TableFormat::Tsv) {
+            buf += ' ';
+        } else if (c == '"' || c == '\\') {
+            buf += '\\';
+            buf += c;
+        } else {
+            static const char hex[] = "0123456789abcdef";
+            buf += "\\u00";
+            buf += hex[c >> 4];
+            buf += hex[c & 15];
+        }
+    }
+    buf.append(text.data() + run, text.size() - run);
+}
+
+void TableWriter::flushIfFull() {
+    if (buf.size() < FLUSH_AT) return;
+    out.write(buf.data(), buf.size());
+    buf.clear();
+}
+
+void TableWriter::cell(std::string_view text) {
+    startCell();
+    if (format == TableFormat::Text) {
+        size_t width = columns[column].width;
+        if (width && text.size() > width) {
+            buf.append(text.data(), width - 3);
+            buf += "...";
+        } else {
+            buf.append(text);
+            if (width) buf.append(width - text.size(), ' ');
+        }
+    } else if (format == TableFormat::Json) {
+        buf += '"';
+        append(text);
+        buf += '"';
+    } else {
+        append(text);
+    }
+    column++;
+}
+
+void TableWriter::cell(long long value) {
+    char digits[24];
+    std::to_chars_result end = std::to_chars(digits, digits + sizeof(digits), value);
+    std::string_view text(digits, end.ptr - digits);
+    if (format != TableFormat::Json) {
+        cell(text);
+        return;
+    }
+    startCell();
+    buf.append(text);
+    column++;
+}
+
+void TableWriter::cell(double value, int decimals) {
+    char digits[32];
+    int length = snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+    std::string_view text(digits, length > 0 ? std::min<size_t>(length, sizeof(digits) - 1) : 0);
+    if (format != TableFormat::Json) {
+        cell(text);
+        return;
+    }
+    startCell();
+    buf.append(text);
+    column++;
+}
+
+void TableWriter::dateCell(time_t t) {
+    cell(dates.format(t));
+}
+
+void TableWriter::endRow() {
+    buf += format == TableFormat::Json ? '}' : '\n';
+    column = 0;
+    rows++;
+    flushIfFull();
+}
+
+void TableWriter::finish() {
+    finished = true;
+    if (format == TableFormat::Text) rule();
+    else if (format == TableFormat::Json) buf += rows ? "\n]\n" : "]\n";
+    out.write(buf.data(), buf.size());
+    out.flush();
+    buf.clear();
+}
@@ -0,0 +1,134 @@
+#include "TextScanner.hpp"
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+const char* findByte(const char* p, const char* end, char c) {
+#if defined(__AVX2__)
+    const __m256i needle = _mm256_set1_epi8(c);
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i needle16 = _mm_set1_epi8(c);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle16)));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && *p != c) p++;
+    return p;
+}
+
+bool parseInt(std::string_view text, long long& out) {
+    if (text.empty()) return false;
+    const char* first = text.data();
+    // from_chars takes '-' but not '+'; one sign only, so "+-5" is rejected
+    if (*first == '+' && ++first != text.data() + text.size() && *first == '-') return false;
+    auto result = std::from_chars(first, text.data() + text.size(), out);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+/* MappedFile */
+MappedFile::MappedFile() : data(nullptr), length(0), mapped(false) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+    if (mapped) munmap(const_cast<char*>(data), length);
+    data = nullptr;
+    length = 0;
+    mapped = false;
+    fallback.clear();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            madvise(p, st.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(p);
+            length = st.st_size;
+            mapped = true;
+            ::close(fd);
+            return true;
+        }
+    }
+    ::close(fd);
+
+    // Pipes, empty files and filesystems without mmap
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    fallback = ss.str();
+    data = fallback.data();
+    length = fallback.size();
+    return true;
+}
+
+/* FieldSplitter */
+FieldSplitter::FieldSplitter(std::string_view text, char delim)
+    : pos(text.data()), end(text.data() + text.size()), delim(delim) {}
+
+bool FieldSplitter::next(std::string_view& field) {
+    if (pos >= end) return false;
+    const char* hit = findByte(pos, end, delim);
+    field = std::string_view(pos, hit - pos);
+    pos = hit < end ? hit + 1 : end;
+    return true;
+}
+
+size_t splitFields(std::string_view text, char delim, std::string_view* out, size_t maxFields) {
+    FieldSplitter fields(text, delim);
+    size_t n = 0;
+    while (n < maxFields && fields.next(out[n])) n++;
+    return n;
+}
+
+std::vector<std::string_view> splitAtLines(std::string_view text, size_t parts) {
+    std::vector<std::string_view> chunks;
+    if (parts == 0) parts = 1;
+    const char* pos = text.data();
+    const char* end = text.data() + text.size();
+    size_t target = text.size() / parts + 1;
+    while (pos < end) {
+        const char* cut = static_cast<size_t>(end - pos) > target ? pos + target : end;
+        cut = cut < end ? findByte(cut, end, '\n') : end;
+        if (cut < end) cut++; // keep the newline with its line
+        chunks.push_back(std::string_view(pos, cut - pos));
+        pos = cut;
+    }
+    return chunks;
+}
+
+/* LineReader */
+LineReader::LineReader(std::string_view text) : pos(text.data()), end(text.data() + text.size()) {}
+
+bool LineReader::next(std::string_view& line) {
+    if (pos >= end) return false;
+    const char* hit = findByte(pos, end, '\n');
+    line = std::string_view(pos, hit - pos);
+    pos = hit < end ? hit + 1 : end;
+    return true;
+}
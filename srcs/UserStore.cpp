@@ -0,0 +1,48 @@
+#include "UserStore.hpp"
+#include <algorithm>
+#include <utility>
+
+Librarian* UserStore::newLibrarian(std::string id, std::string name, std::string email) {
+    return librarianPool.create(std::move(id), std::move(name), std::move(email));
+}
+
+Member* UserStore::newMember(std::string id, std::string name, std::string email) {
+    return memberPool.create(std::move(id), std::move(name), std::move(email));
+}
+
+void UserStore::add(Person* user) {
+    if (Member* m = asMember(user)) memberList.push_back(m);
+    else if (Librarian* l = asLibrarian(user)) librarianList.push_back(l);
+}
+
+template <typename T>
+static void unlist(std::vector<T*>& list, T* user) {
+    auto it = std::find(list.begin(), list.end(), user);
+    if (it != list.end()) list.erase(it);
+}
+
+void UserStore::erase(Person* user) {
+    if (Member* m = asMember(user)) {
+        unlist(memberList, m);
+        memberPool.destroy(m);
+    } else if (Librarian* l = asLibrarian(user)) {
+        unlist(librarianList, l);
+        librarianPool.destroy(l);
+    }
+}
+
+void UserStore::adopt(UserStore& other) {
+    librarianPool.adopt(other.librarianPool);
+    memberPool.adopt(other.memberPool);
+    librarianList.insert(librarianList.end(), other.librarianList.begin(), other.librarianList.end());
+    memberList.insert(memberList.end(), other.memberList.begin(), other.memberList.end());
+    other.librarianList.clear();
+    other.memberList.clear();
+}
+
+void UserStore::clear() {
+    librarianList.clear();
+    memberList.clear();
+    librarianPool.clear();
+    memberPool.clear();
+}
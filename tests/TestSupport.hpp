@@ -0,0 +1,55 @@
+#ifndef TESTSUPPORT_HPP
+#define TESTSUPPORT_HPP
+
+// Shared by the tests: a check macro that counts failures, and helpers to
+// run part of a test in a child process that is killed mid-operation
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+#define CHECK(cond)                                                             \
+    do {                                                                        \
+        if (!(cond)) {                                                          \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+// Fresh data directory with the admin account and one member, "m1"
+static std::string freshDataDir(const std::string& name) {
+    std::string dir = "/tmp/library_test_" + name;
+    std::system(("rm -rf " + dir + " && mkdir -p " + dir).c_str());
+    FILE* users = std::fopen((dir + "/users.txt").c_str(), "w");
+    std::fputs("Librarian|admin|Admin|admin@library.com\nMember|m1|Member One|m1@mail.com|\n", users);
+    std::fclose(users);
+    FILE* books = std::fopen((dir + "/books.txt").c_str(), "w");
+    std::fclose(books);
+    return dir;
+}
+
+// Runs fn in a child process, which is expected to die of SIGKILL before
+// fn returns; false if it exited any other way
+template <typename F>
+static bool runKilled(F fn) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        fn();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+}
+
+static int report(const char* name) {
+    if (failures) std::fprintf(stderr, "%s: %d check(s) failed\n", name, failures);
+    else std::printf("%s: ok\n", name);
+    return failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,89 @@
+// Crash recovery: the process is killed at each step of a checkpoint
+// (after the log is rotated, after one base file, after both) and with no
+// checkpoint at all. Reopening must show every operation exactly once.
+#include "LibrarySystem.hpp"
+#include "TestSupport.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// A rename() whose destination ends with this kills the process right
+// after it; the checkpoint code reaches it through std::rename
+static const char* killAfterRenameTo = nullptr;
+
+extern "C" int rename(const char* from, const char* to) {
+    int result = renameat(AT_FDCWD, from, AT_FDCWD, to);
+    size_t length = std::strlen(to), suffix = killAfterRenameTo ? std::strlen(killAfterRenameTo) : 0;
+    if (killAfterRenameTo && length >= suffix && std::strcmp(to + length - suffix, killAfterRenameTo) == 0)
+        kill(getpid(), SIGKILL);
+    return result;
+}
+
+static bool exists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+// 20 books, 3 of them lent to m1, one reserved, one removed, a new member
+static void populate(LibrarySystem& app) {
+    for (int i = 0; i < 21; i++) app.addBook("Title " + std::to_string(i), "Author", "Fiction");
+    app.removeBook("21");
+    app.registerUser(Role::Member, "m2", "Member Two", "m2@mail.com");
+    for (const char* id : {"1", "2", "3"}) app.borrow("m1", id);
+    app.reserve("m2", "1");
+}
+
+static void verify(const std::string& dir, const char* when) {
+    for (int pass = 0; pass < 2; pass++) {
+        // The second pass opens what the first one saved on exit
+        LibrarySystem app(DataFormat::Text, dir);
+        std::vector<Book> all = app.search("");
+        Book book("", "", "", "", 0);
+        UserInfo user;
+        if (all.size() != 20) std::fprintf(stderr, "%s (pass %d): %zu books\n", when, pass, all.size());
+        CHECK(all.size() == 20);
+        CHECK(!app.findBook("21", book));
+        CHECK(app.borrowedBy("m1").size() == 3);
+        CHECK(app.findUserInfo("m2", user));
+        CHECK(app.findBook("1", book) && book.hasReservations());
+        CHECK(app.historySize("m1") == 3);
+    }
+}
+
+static void crashDuringSave(DataFormat format, const char* killAfter, const char* name) {
+    std::string dir = freshDataDir(name);
+    bool killed = runKilled([&]() {
+        LibrarySystem app(format, dir);
+        populate(app);
+        killAfterRenameTo = killAfter;
+        app.saveData();
+    });
+    CHECK(killed);
+    verify(dir, name);
+}
+
+int main() {
+    // No checkpoint: everything is in the log
+    std::string dir = freshDataDir("no_checkpoint");
+    CHECK(runKilled([&]() {
+        LibrarySystem app(DataFormat::Text, dir);
+        populate(app);
+        kill(getpid(), SIGKILL);
+    }));
+    verify(dir, "no checkpoint");
+
+    // Log rotated, base not yet written: the rotated segment holds it all
+    crashDuringSave(DataFormat::Text, "library.wal.1", "after_rotate");
+    // books.txt is new and users.txt still the old base; each file's LSN
+    // decides which records it still needs
+    crashDuringSave(DataFormat::Text, "books.txt", "after_books");
+    // Both base files written, rotated segment not yet deleted
+    crashDuringSave(DataFormat::Text, "users.txt", "after_users");
+    CHECK(!exists("/tmp/library_test_after_users/library.wal.1"));
+    // The binary base is a single file
+    crashDuringSave(DataFormat::Binary, "library.wal.1", "binary_after_rotate");
+    crashDuringSave(DataFormat::Binary, "library.snap", "binary_after_snapshot");
+
+    std::system("rm -rf /tmp/library_test_*");
+    return report("test_recovery");
+}
@@ -0,0 +1,80 @@
+// A torn or corrupt end of the operation log, as left by a crash in the
+// middle of a write: recovery keeps every good record before it, and
+// operations logged after recovery survive the next crash too.
+#include "LibrarySystem.hpp"
+#include "TestSupport.hpp"
+#include <fstream>
+#include <sstream>
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+}
+
+// Adds count books and dies without saving, so they exist only in the log
+static void addAndCrash(const std::string& dir, int count) {
+    bool killed = runKilled([&]() {
+        LibrarySystem app(DataFormat::Text, dir);
+        for (int i = 0; i < count; i++) app.addBook("Title", "Author", "Fiction");
+        app.borrow("m1", "1");
+        kill(getpid(), SIGKILL);
+    });
+    CHECK(killed);
+}
+
+static size_t bookCount(const std::string& dir) {
+    LibrarySystem app(DataFormat::Text, dir, 0, AccessMode::ReadOnly);
+    return app.search("").size();
+}
+
+int main() {
+    // A final line cut off mid-write is ignored
+    std::string dir = freshDataDir("torn_tail");
+    std::string wal = dir + "/library.wal";
+    addAndCrash(dir, 5);
+    std::string log = readFile(wal);
+    writeFile(wal, log + "7|ADDBOOK|6|Torn Ti");
+    CHECK(bookCount(dir) == 5);
+
+    // Records logged after recovering from a torn tail are not lost behind it
+    addAndCrash(dir, 2);
+    CHECK(bookCount(dir) == 7);
+    {
+        LibrarySystem app(DataFormat::Text, dir);
+        CHECK(app.borrowedBy("m1").size() == 1);
+    }
+    CHECK(bookCount(dir) == 7);
+
+    // A complete last line with a bad checksum is dropped, the rest kept
+    dir = freshDataDir("bad_crc");
+    wal = dir + "/library.wal";
+    addAndCrash(dir, 3);
+    log = readFile(wal);
+    log[log.find("|BORROW|") + 1] ^= 0x20; // "bORROW": the checksum no longer matches
+    writeFile(wal, log);
+    {
+        // Replay stops there, so the history record after it goes too
+        LibrarySystem app(DataFormat::Text, dir);
+        CHECK(app.search("").size() == 3);
+        CHECK(app.borrowedBy("m1").empty());
+        CHECK(app.historySize("m1") == 0);
+    }
+
+    // Only part of the header line of a record survived
+    dir = freshDataDir("torn_lsn");
+    wal = dir + "/library.wal";
+    addAndCrash(dir, 4);
+    writeFile(wal, readFile(wal) + "1");
+    CHECK(bookCount(dir) == 4);
+    addAndCrash(dir, 1);
+    CHECK(bookCount(dir) == 5);
+
+    std::system("rm -rf /tmp/library_test_*");
+    return report("test_wal_tail");
+}